@@ -0,0 +1,55 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Enemies/EnemyAttackSubsystem.h"
+
+#include "Enemies/EnemyBase.h"
+
+void UEnemyAttackSubsystem::AddAttacker(AEnemyBase* enemy)
+{
+	if (enemy)
+	{
+		attackers.AddUnique(enemy);
+	}
+}
+
+void UEnemyAttackSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	// Handled after the walk, the Blueprint hooks can start attacks or pool the enemy
+	TArray<AEnemyBase*, TInlineAllocator<16>> phaseEnded;
+
+	for (int32 i = attackers.Num() - 1; i >= 0; i--)
+	{
+		AEnemyBase* enemy = attackers[i].Get();
+		if (enemy == nullptr || enemy->IsPooled() || enemy->GetAttackPhase() == EEnemyAttackPhase::Idle)
+		{
+			attackers.RemoveAtSwap(i);
+			continue;
+		}
+
+		if (enemy->RunDownAttackPhase(DeltaTime))
+		{
+			phaseEnded.Add(enemy);
+		}
+	}
+
+	for (AEnemyBase* enemy : phaseEnded)
+	{
+		if (IsValid(enemy) && !enemy->IsPooled())
+		{
+			enemy->AdvanceAttackPhase();
+		}
+	}
+}
+
+bool UEnemyAttackSubsystem::IsTickable() const
+{
+	return attackers.Num() > 0;
+}
+
+TStatId UEnemyAttackSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UEnemyAttackSubsystem, STATGROUP_Tickables);
+}
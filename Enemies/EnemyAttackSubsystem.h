@@ -0,0 +1,40 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "EnemyAttackSubsystem.generated.h"
+
+class AEnemyBase;
+
+UENUM(BlueprintType)
+enum class EEnemyAttackPhase : uint8
+{
+	Idle,
+	Windup,
+	Active,
+	Recovery,
+	/** What is left of attackSpeed after the other phases, no new attack until it runs out */
+	Cooldown
+};
+
+/**
+ * Runs down the attack phases of every attacking enemy in native code. Enemies only hear about it, and go
+ * through the Blueprint VM, when a phase ends (AEnemyBase::OnAttackPhaseChanged).
+ */
+UCLASS()
+class RCT_API UEnemyAttackSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	void AddAttacker(AEnemyBase* enemy);
+
+	virtual void Tick(float DeltaTime) override;
+	virtual bool IsTickable() const override;
+	virtual TStatId GetStatId() const override;
+
+private:
+	TArray<TWeakObjectPtr<AEnemyBase>> attackers;
+};
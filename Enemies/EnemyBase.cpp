@@ -3,25 +3,33 @@
 
 #include "Enemies/EnemyBase.h"
 #include "Enemies/EnemyStatData.h"
+#include "Enemies/EnemyStatCache.h"
+#include "Enemies/EnemyPoolSubsystem.h"
+#include "Enemies/EnemyFlowFieldSubsystem.h"
+#include "Enemies/EnemyMovementComponent.h"
+#include "Enemies/EnemyAttackSubsystem.h"
+#include "Enemies/EnemyCorpseSubsystem.h"
 #include "Engine/DataTable.h"
-#include "Objects/LevelTransitionVolumeBase.h"
+#include "Systems/ActorRegistrySubsystem.h"
+#include "Systems/DamageOverTimeSubsystem.h"
+#include "Systems/GameplayEventSubsystem.h"
 #include "GameFramework/CharacterMovementComponent.h"
 #include <Runtime/Engine/Classes/Kismet/GameplayStatics.h>
 
 #include "AIController.h"
 #include "BrainComponent.h"
+#include "Navigation/PathFollowingComponent.h"
 #include "Components/CapsuleComponent.h"
 
 // Sets default values
-AEnemyBase::AEnemyBase()
+AEnemyBase::AEnemyBase(const FObjectInitializer& ObjectInitializer)
+	: Super(ObjectInitializer.SetDefaultSubobjectClass<UEnemyMovementComponent>(ACharacter::CharacterMovementComponentName))
 {
  	// Set this pawn to call Tick() every frame.  You can turn this off to improve performance if you don't need it.
 	PrimaryActorTick.bCanEverTick = true;
-	ConstructorHelpers::FObjectFinder<UDataTable> enemyStatsObject(TEXT("DataTable'/Game/DataFiles/EnemyDataTable.EnemyDataTable'"));
-	if (enemyStatsObject.Succeeded())
-	{
-		enemyStatsTable = enemyStatsObject.Object;
-	}
+	// the stats table is loaded once by UEnemyStatCache
+	enemyStatsTable = nullptr;
+	significance = EEnemySignificance::High;
 }
 
 // Called when the game starts or when spawned
@@ -30,17 +38,28 @@ void AEnemyBase::BeginPlay()
 	Super::BeginPlay();
 	SetupStats();
 
-	auto alevelTransitionVolume = UGameplayStatics::GetActorOfClass(GetWorld(), ALevelTransitionVolumeBase::StaticClass());
-	auto levelTransitionVolume = Cast<ALevelTransitionVolumeBase>(alevelTransitionVolume);
-
-	if (levelTransitionVolume) 
+#if WITH_EDITOR
+	if (UEnemyStatCache* statCache = GetGameInstance() ? GetGameInstance()->GetSubsystem<UEnemyStatCache>() : nullptr)
 	{
-		levelTransitionVolume -> enemyCount++;
-		// deathEvent.AddUObject(levelTransitionVolume, &ALevelTransitionVolumeBase::EnemyDied);
-		hpZeroEvent.AddDynamic(levelTransitionVolume, &ALevelTransitionVolumeBase::EnemyDied);
+		statsReloadedHandle = statCache->onStatsReloaded.AddUObject(this, &AEnemyBase::OnStatsReloaded);
 	}
+#endif
 
+	defaultCollisionProfileName = GetCapsuleComponent()->GetCollisionProfileName();
 	health = maxHealth;
+
+	actorRegistry = GetWorld()->GetSubsystem<UActorRegistrySubsystem>();
+	if (bStartPooled)
+	{
+		DeactivateForPool();
+		return;
+	}
+
+	// the registry counts us in the level transition volume and tells it when we die
+	if (actorRegistry)
+	{
+		actorRegistry->RegisterEnemy(this);
+	}
 }
 
 // Called every frame
@@ -50,13 +69,59 @@ void AEnemyBase::Tick(float DeltaTime)
 
 }
 
+bool AEnemyBase::NeedsActorTick() const
+{
+	static const FName receiveTickName(TEXT("ReceiveTick"));
+	return GetClass()->IsFunctionImplementedInScript(receiveTickName);
+}
+
+void AEnemyBase::ApplySignificance(EEnemySignificance newSignificance, float tickInterval)
+{
+	significance = newSignificance;
+
+	const bool bNeedsTick = NeedsActorTick();
+	SetActorTickEnabled(bNeedsTick);
+	if (bNeedsTick)
+	{
+		SetActorTickInterval(tickInterval);
+	}
+
+	GetCharacterMovement()->SetComponentTickInterval(tickInterval);
+	GetMesh()->SetComponentTickInterval(tickInterval);
+
+	AAIController* AIC = Cast<AAIController>(GetController());
+	if (AIC)
+	{
+		if (AIC->GetBrainComponent())
+		{
+			AIC->GetBrainComponent()->SetComponentTickInterval(tickInterval);
+		}
+		if (AIC->GetPathFollowingComponent())
+		{
+			AIC->GetPathFollowingComponent()->SetComponentTickInterval(tickInterval);
+		}
+	}
+}
+
 void AEnemyBase::EndPlay(const EEndPlayReason::Type EndPlayReason)
 {
 	Super::EndPlay(EndPlayReason);
 
+	if (actorRegistry)
+	{
+		actorRegistry->UnregisterEnemy(this);
+	}
+
+#if WITH_EDITOR
+	if (UEnemyStatCache* statCache = GetGameInstance() ? GetGameInstance()->GetSubsystem<UEnemyStatCache>() : nullptr)
+	{
+		statCache->onStatsReloaded.Remove(statsReloadedHandle);
+	}
+#endif
+
 	if (EndPlayReason == EEndPlayReason::Destroyed)
 	{
-		deathEvent.Broadcast();
+		BroadcastDeath();
 	}
 }
 
@@ -67,6 +132,11 @@ bool AEnemyBase::IsDead()
 
 float AEnemyBase::TakeDamage(float damageAmount, FDamageEvent const& damageEvent, AController* eventInstigator, AActor* damageCauser)
 {
+	if (bPooled)
+	{
+		return 0.f;
+	}
+
 	ModifyHealth(-damageAmount);
 	
 	if (health == 0 && !bIsDead)
@@ -89,7 +159,10 @@ float AEnemyBase::TakeDamage(float damageAmount, FDamageEvent const& damageEvent
 		// caps->SetCollisionResponseToChannel(ECollisionChannel::ECC_GameTraceChannel2, ECollisionResponse::ECR_Ignore);
 		caps->SetCollisionProfileName("Ragdoll");
 
-		GetWorldTimerManager().SetTimer(deathTimerHandle, this, &AEnemyBase::DelayedDestroy, deathTimeBeforeRespawn, false);
+		if (UEnemyCorpseSubsystem* corpses = GetWorld()->GetSubsystem<UEnemyCorpseSubsystem>())
+		{
+			corpses->AddCorpse(this, deathTimeBeforeRespawn);
+		}
 	}
 	return Super::TakeDamage(damageAmount, damageEvent, eventInstigator, damageCauser);
 }
@@ -103,25 +176,40 @@ void AEnemyBase::SetupPlayerInputComponent(UInputComponent* PlayerInputComponent
 
 void AEnemyBase::SetupStats()
 {
-	FString contextString = FString(TEXT("Enemy Stats Init"));
-	FEnemyStatData* enemyStatData = enemyStatsTable->FindRow<FEnemyStatData>(enemyName, contextString);
+	UEnemyStatCache* statCache = GetGameInstance() ? GetGameInstance()->GetSubsystem<UEnemyStatCache>() : nullptr;
+	if (statCache == nullptr)
+	{
+		return;
+	}
+
+	enemyStatsTable = statCache->GetTable();
+	if (enemyTypeId == INDEX_NONE)
+	{
+		enemyTypeId = statCache->ResolveTypeId(GetClass(), enemyName);
+	}
+
+	const FEnemyStatData* enemyStatData = statCache->GetStats(enemyTypeId);
 	if (enemyStatData == nullptr)
 	{
-		UE_LOG(LogTemp, Warning, TEXT("Unable to find enemy stats for %s"), *GetName());
 		return;
 	}
-	/*maxHealth = enemyStatData->HP;
-	damage = enemyStatData->Attack;*/
-	attackSpeed = enemyStatData->AttackCooldown;
-	pursueRadius = enemyStatData->PursuitRadius;
-	attackRange = enemyStatData->AttackRange;
-	bIsGrabbable = enemyStatData->IsGrabbable;
+	ApplyStats(*enemyStatData);
+}
+
+void AEnemyBase::ApplyStats(const FEnemyStatData& enemyStatData)
+{
+	/*maxHealth = enemyStatData.HP;
+	damage = enemyStatData.Attack;*/
+	attackSpeed = enemyStatData.AttackCooldown;
+	pursueRadius = enemyStatData.PursuitRadius;
+	attackRange = enemyStatData.AttackRange;
+	bIsGrabbable = enemyStatData.IsGrabbable;
 
 	auto moveComponent = Cast<UCharacterMovementComponent>(GetMovementComponent());
 
 	if (moveComponent)
 	{
-		moveComponent->MaxWalkSpeed = enemyStatData->Speed;
+		moveComponent->MaxWalkSpeed = enemyStatData.Speed;
 	}
 
 	// TODO figure out how to determine static or skeletal (or choose one)
@@ -130,17 +218,17 @@ void AEnemyBase::SetupStats()
 	if (mesh)
 	{
 		FBodyInstance* bodyInst = mesh->GetBodyInstance();
-		bodyInst->MassScale = enemyStatData->Mass;
+		bodyInst->MassScale = enemyStatData.Mass;
 		bodyInst->UpdateMassProperties();
 	}*/
 }
 
-void AEnemyBase::ApplyArmStayDamage()
+#if WITH_EDITOR
+void AEnemyBase::OnStatsReloaded()
 {
-	// ModifyHealth(armStayDamage);
-	AActor* Player = UGameplayStatics::GetPlayerCharacter(GetWorld(), 0);
-	TakeDamage(armStayDamage, FPointDamageEvent(), Player->GetInstigatorController(), Player);
+	SetupStats();
 }
+#endif
 
 float AEnemyBase::GetMaxHealth() const
 {
@@ -169,48 +257,325 @@ FGameplayTagContainer AEnemyBase::GetAbilityTags() const
 
 void AEnemyBase::ModifyHealth(float modifier)
 {
+	const float previousHealth = health;
 	health += modifier;
 	//DrawDebugString(GetWorld(), GetTransform().GetLocation(), FString::Printf(TEXT("Damage: %.3f"), -modifier), nullptr, FColor::Red, 2.0f, false);
 	health = FMath::Clamp(health, 0, maxHealth);
-	if (health == 0)
+	// only on the hit that kills, hits on a dead enemy would prompt for devour again
+	if (previousHealth > 0 && health == 0)
+	{
+		BroadcastHPZero();
+	}
+}
+
+void AEnemyBase::BroadcastHPZero()
+{
+	if (actorRegistry)
+	{
+		actorRegistry->EnemyDefeated(this);
+	}
+	CancelAttack();
+
+	if (UGameplayEventSubsystem* gameplayEvents = GetWorld()->GetSubsystem<UGameplayEventSubsystem>())
+	{
+		gameplayEvents->onEnemyHPZero.Broadcast({ this });
+	}
+	if (hpZeroEvent.IsBound())
 	{
 		hpZeroEvent.Broadcast();
-		hpZeroEvent.Clear();
+	}
+}
+
+void AEnemyBase::BroadcastDeath()
+{
+	if (deathEvent.IsBound())
+	{
+		deathEvent.Broadcast();
 	}
 }
 
 void AEnemyBase::Stun_Implementation()
 {}
 
+bool AEnemyBase::StartAttack(AActor* target)
+{
+	if (bIsDead || bPooled || attackPhase != EEnemyAttackPhase::Idle)
+	{
+		return false;
+	}
+
+	UEnemyAttackSubsystem* attackSubsystem = GetWorld()->GetSubsystem<UEnemyAttackSubsystem>();
+	if (attackSubsystem == nullptr)
+	{
+		return false;
+	}
+
+	attackTarget = target;
+	attackSubsystem->AddAttacker(this);
+	SetAttackPhase(EEnemyAttackPhase::Windup);
+	return true;
+}
+
+void AEnemyBase::CancelAttack()
+{
+	if (IsAttacking())
+	{
+		SetAttackPhase(EEnemyAttackPhase::Cooldown);
+	}
+}
+
+bool AEnemyBase::IsAttacking() const
+{
+	return attackPhase == EEnemyAttackPhase::Windup
+		|| attackPhase == EEnemyAttackPhase::Active
+		|| attackPhase == EEnemyAttackPhase::Recovery;
+}
+
 void AEnemyBase::Attack_Implementation(float DeltaTime, AActor* target)
-{}
+{
+	StartAttack(target);
+}
 
 bool AEnemyBase::AttackHasFinished() const
 {
-	return bAttackFinished;
+	return !IsAttacking();
 }
 
 void AEnemyBase::FinishAttack()
 {
-	bAttackFinished = true;
+	if (attackPhase == EEnemyAttackPhase::Windup || attackPhase == EEnemyAttackPhase::Active)
+	{
+		SetAttackPhase(EEnemyAttackPhase::Recovery);
+	}
 }
 
 void AEnemyBase::ResetAttack()
+{}
+
+bool AEnemyBase::RunDownAttackPhase(float DeltaTime)
+{
+	attackPhaseTimeLeft -= DeltaTime;
+	return attackPhaseTimeLeft <= 0.f;
+}
+
+void AEnemyBase::AdvanceAttackPhase()
+{
+	while (attackPhase != EEnemyAttackPhase::Idle && attackPhaseTimeLeft <= 0.f)
+	{
+		// the time we went over comes off the next phase
+		const float overshoot = attackPhaseTimeLeft;
+		switch (attackPhase)
+		{
+		case EEnemyAttackPhase::Windup:
+			SetAttackPhase(EEnemyAttackPhase::Active);
+			break;
+		case EEnemyAttackPhase::Active:
+			SetAttackPhase(EEnemyAttackPhase::Recovery);
+			break;
+		case EEnemyAttackPhase::Recovery:
+			SetAttackPhase(EEnemyAttackPhase::Cooldown);
+			break;
+		default:
+			SetAttackPhase(EEnemyAttackPhase::Idle);
+			break;
+		}
+		attackPhaseTimeLeft += overshoot;
+	}
+}
+
+void AEnemyBase::SetAttackPhase(EEnemyAttackPhase newPhase)
 {
-	bAttackFinished = false;
+	attackPhase = newPhase;
+	attackPhaseTimeLeft = GetAttackPhaseDuration(newPhase);
+	OnAttackPhaseChanged(newPhase, attackTarget.Get());
+
+	if (attackPhase == EEnemyAttackPhase::Idle)
+	{
+		attackTarget = nullptr;
+	}
 }
 
-void AEnemyBase::TakePeriodicDamage(float amount, float timeInterval)
+float AEnemyBase::GetAttackPhaseDuration(EEnemyAttackPhase phase) const
 {
-	armStayDamage = amount;
-	GetWorldTimerManager().SetTimer(periodicDamageHandle, this, &AEnemyBase::ApplyArmStayDamage, timeInterval, true, timeInterval);
+	switch (phase)
+	{
+	case EEnemyAttackPhase::Windup:
+		return attackWindupTime;
+	case EEnemyAttackPhase::Active:
+		return attackActiveTime;
+	case EEnemyAttackPhase::Recovery:
+		return attackRecoveryTime;
+	case EEnemyAttackPhase::Cooldown:
+		// attackSpeed stays the shortest interval between two attacks
+		return FMath::Max(0.f, attackSpeed - attackWindupTime - attackActiveTime - attackRecoveryTime);
+	default:
+		return 0.f;
+	}
+}
+
+void AEnemyBase::OnAttackPhaseChanged_Implementation(EEnemyAttackPhase newPhase, AActor* target)
+{}
+
+void AEnemyBase::TakePeriodicDamage(float amount, float timeInterval, AActor* source)
+{
+	UDamageOverTimeSubsystem* damageOverTime = GetWorld()->GetSubsystem<UDamageOverTimeSubsystem>();
+	if (damageOverTime == nullptr)
+	{
+		return;
+	}
+
+	// a zero interval never fired with the old looping timer either
+	if (timeInterval <= 0.f)
+	{
+		damageOverTime->RemoveEffect(this, EDamageOverTimeKind::ArmStay);
+		return;
+	}
+
+	if (source == nullptr)
+	{
+		source = UGameplayStatics::GetPlayerCharacter(GetWorld(), 0);
+	}
+	damageOverTime->AddEffect(this, source, EDamageOverTimeKind::ArmStay, amount, timeInterval, false);
 }
 
 void AEnemyBase::StopPeriodicDamage()
 {
-		GetWorldTimerManager().ClearTimer(periodicDamageHandle);
+	if (UDamageOverTimeSubsystem* damageOverTime = GetWorld()->GetSubsystem<UDamageOverTimeSubsystem>())
+	{
+		damageOverTime->RemoveEffect(this, EDamageOverTimeKind::ArmStay);
+	}
+}
+
+void AEnemyBase::MoveAlongFlowField(float scale)
+{
+	if (UEnemyFlowFieldSubsystem* flowField = GetWorld()->GetSubsystem<UEnemyFlowFieldSubsystem>())
+	{
+		AddMovementInput(flowField->GetDirectionToPlayer(GetActorLocation()), scale);
+	}
+}
+
+void AEnemyBase::Despawn()
+{
+	if (bPooled)
+	{
+		return;
+	}
+
+	UEnemyPoolSubsystem* pool = GetWorld()->GetSubsystem<UEnemyPoolSubsystem>();
+	if (pool == nullptr)
+	{
+		Destroy();
+		return;
+	}
+
+	// a destroyed enemy broadcasts deathEvent in EndPlay, a pooled one has to do it here
+	if (pool->ReleaseEnemy(this))
+	{
+		BroadcastDeath();
+
+		// whoever bound to this life is done with it, the next one binds again in OnActivatedFromPool
+		deathEvent.Clear();
+		hpZeroEvent.Clear();
+	}
+}
+
+bool AEnemyBase::IsCorpseSimulating() const
+{
+	return GetCapsuleComponent()->IsSimulatingPhysics() || (GetMesh()->IsAnySimulatingPhysics() && GetMesh()->IsAnyRigidBodyAwake());
+}
+
+bool AEnemyBase::IsCorpseNearGround(float maxDistance) const
+{
+	// the capsule after a throw, the ragdoll otherwise
+	const UPrimitiveComponent* body = GetCapsuleComponent();
+	if (!body->IsSimulatingPhysics())
+	{
+		body = GetMesh();
+	}
+	const FVector start = body->Bounds.Origin;
+	const FVector end = start - FVector(0.f, 0.f, body->Bounds.BoxExtent.Z + maxDistance);
+
+	FHitResult hit;
+	FCollisionQueryParams params(SCENE_QUERY_STAT(CorpseGround), false, this);
+	return GetWorld()->LineTraceSingleByChannel(hit, start, end, ECC_WorldStatic, params);
+}
+
+void AEnemyBase::FreezeCorpse()
+{
+	GetCapsuleComponent()->SetSimulatePhysics(false);
+	// asleep instead of not simulating, the ragdoll keeps its pose rather than blending back to the animation
+	GetMesh()->PutAllRigidBodiesToSleep();
+}
+
+void AEnemyBase::DeactivateForPool()
+{
+	bPooled = true;
+	attackPhase = EEnemyAttackPhase::Idle;
+	attackTarget = nullptr;
+
+	if (actorRegistry)
+	{
+		actorRegistry->UnregisterEnemy(this);
+	}
+
+	GetWorldTimerManager().ClearAllTimersForObject(this);
+	if (UDamageOverTimeSubsystem* damageOverTime = GetWorld()->GetSubsystem<UDamageOverTimeSubsystem>())
+	{
+		damageOverTime->RemoveAllEffects(this);
+	}
+	DetachFromActor(FDetachmentTransformRules::KeepWorldTransform);
+
+	AAIController* AIC = Cast<AAIController>(GetController());
+	if (AIC && AIC->GetBrainComponent())
+	{
+		AIC->GetBrainComponent()->StopLogic("Pooled");
+	}
+
+	UCharacterMovementComponent* moveComponent = GetCharacterMovement();
+	moveComponent->StopMovementImmediately();
+	moveComponent->DisableMovement();
+	moveComponent->SetComponentTickEnabled(false);
+	GetMesh()->SetComponentTickEnabled(false);
+
+	SetActorHiddenInGame(true);
+	SetActorEnableCollision(false);
+	SetActorTickEnabled(false);
 }
 
-void AEnemyBase::DelayedDestroy() {
-	Destroy();
+void AEnemyBase::ActivateFromPool(const FTransform& transform)
+{
+	SetActorTransform(transform, false, nullptr, ETeleportType::ResetPhysics);
+
+	bIsDead = false;
+	playerSense = FEnemyPlayerSense();
+	GetCapsuleComponent()->SetCollisionProfileName(defaultCollisionProfileName);
+
+	SetupStats();
+	health = maxHealth;
+
+	UCharacterMovementComponent* moveComponent = GetCharacterMovement();
+	moveComponent->SetComponentTickEnabled(true);
+	moveComponent->SetDefaultMovementMode();
+	GetMesh()->SetComponentTickEnabled(true);
+
+	SetActorHiddenInGame(false);
+	SetActorEnableCollision(true);
+
+	// back under the significance rules with the last rank, the next pass refines it
+	const UEnemySignificanceSubsystem* significanceSubsystem = GetWorld()->GetSubsystem<UEnemySignificanceSubsystem>();
+	ApplySignificance(significance, significanceSubsystem ? significanceSubsystem->GetTickInterval(significance) : 0.f);
+
+	AAIController* AIC = Cast<AAIController>(GetController());
+	if (AIC && AIC->GetBrainComponent())
+	{
+		AIC->GetBrainComponent()->RestartLogic();
+	}
+
+	bPooled = false;
+	bStartPooled = false;
+
+	if (actorRegistry)
+	{
+		actorRegistry->RegisterEnemy(this);
+	}
 }
\ No newline at end of file
@@ -6,6 +6,9 @@
 
 #include "CoreMinimal.h"
 #include "GameFramework/Character.h"
+#include "Enemies/EnemyAttackSubsystem.h"
+#include "Enemies/EnemyPerceptionSubsystem.h"
+#include "Enemies/EnemySignificanceSubsystem.h"
 #include "EnemyBase.generated.h"
 
 DECLARE_DYNAMIC_MULTICAST_DELEGATE(FEnemyDeathEvent);
@@ -16,12 +19,9 @@ class RCT_API AEnemyBase : public ACharacter
 {
 	GENERATED_BODY()
 
-private:
-	void DelayedDestroy();
-
 public:
 	// Sets default values for this pawn's properties
-	AEnemyBase();
+	AEnemyBase(const FObjectInitializer& ObjectInitializer);
 
 	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 	/** Returns Enemies Max Health */
@@ -32,21 +32,74 @@ public:
 	UFUNCTION(BlueprintCallable, BlueprintPure)
 	float GetHealth() const;
 
-	UFUNCTION(BlueprintCallable, BlueprintPure)
-	bool AttackHasFinished() const;
-
 	/** Returns the Enemies Pursuit Radius */
 	UFUNCTION(BlueprintCallable, BlueprintPure)
 	float GetPursueRadius() const;
 
-	UFUNCTION(BlueprintCallable, BlueprintNativeEvent)
-	void Attack(float DeltaTime, AActor* target = nullptr);
+	UFUNCTION(BlueprintCallable, BlueprintPure)
+	float GetAttackRange() const
+	{
+		return attackRange;
+	}
+
+	/** Distance, ranges and line of sight to the player as of this frame, kept up to date by UEnemyPerceptionSubsystem */
+	UFUNCTION(BlueprintCallable, BlueprintPure)
+	const FEnemyPlayerSense& GetPlayerSense() const
+	{
+		return playerSense;
+	}
 
+	void SetPlayerSense(const FEnemyPlayerSense& sense)
+	{
+		playerSense = sense;
+	}
+
+	/** Starts the windup against @target, false while another attack or its cooldown is still going */
+	UFUNCTION(BlueprintCallable)
+	bool StartAttack(AActor* target = nullptr);
+
+	/** Cuts the current attack short, straight to the cooldown */
 	UFUNCTION(BlueprintCallable)
+	void CancelAttack();
+
+	UFUNCTION(BlueprintCallable, BlueprintPure)
+	EEnemyAttackPhase GetAttackPhase() const
+	{
+		return attackPhase;
+	}
+
+	/** In windup, active or recovery */
+	UFUNCTION(BlueprintCallable, BlueprintPure)
+	bool IsAttacking() const;
+
+	/** Kept for Blueprints and behaviour tree tasks written before the attack phases, starts an attack on @target */
+	UFUNCTION(BlueprintCallable, BlueprintNativeEvent, meta = (DeprecatedFunction, DeprecationMessage = "Use StartAttack and OnAttackPhaseChanged"))
+	void Attack(float DeltaTime, AActor* target = nullptr);
+
+	UFUNCTION(BlueprintCallable, BlueprintPure, meta = (DeprecatedFunction, DeprecationMessage = "Use IsAttacking"))
+	bool AttackHasFinished() const;
+
+	/** Skips what is left of the windup and active phases */
+	UFUNCTION(BlueprintCallable, meta = (DeprecatedFunction, DeprecationMessage = "Attacks run through their phases on their own"))
+	void FinishAttack();
+
+	/** Does nothing, an attack is ready again once its cooldown ran out */
+	UFUNCTION(BlueprintCallable, meta = (DeprecatedFunction, DeprecationMessage = "Attacks reset on their own after the cooldown"))
 	void ResetAttack();
 
+	/** Called by UEnemyAttackSubsystem every frame of an attack, returns true once the current phase is over */
+	bool RunDownAttackPhase(float DeltaTime);
+
+	/** Moves on from the phase that ran out, through every phase a long frame went past */
+	void AdvanceAttackPhase();
+
+	/** Walks towards the player along UEnemyFlowFieldSubsystem's shared field, call it every tick instead of a MoveTo */
+	UFUNCTION(BlueprintCallable)
+	void MoveAlongFlowField(float scale = 1.f);
+
+	/** Arm stay damage, @amount every @timeInterval from @source (the player if null) until StopPeriodicDamage */
 	UFUNCTION()
-	void TakePeriodicDamage(float amount, float timeInterval);
+	void TakePeriodicDamage(float amount, float timeInterval, AActor* source = nullptr);
 
 	UFUNCTION()
 	void StopPeriodicDamage();
@@ -66,19 +119,93 @@ public:
 
 	virtual float TakeDamage(float damageAmount, FDamageEvent const& damageEvent, AController* eventInstigator, AActor* damageCauser) override;
 
+	/** Hands the enemy back to UEnemyPoolSubsystem, or destroys it when there is no pool */
+	UFUNCTION(BlueprintCallable)
+	void Despawn();
+
+	/** Whether the dead body is still moved by physics, the capsule after a throw or a ragdolled mesh */
+	bool IsCorpseSimulating() const;
+
+	/** Whether the simulated body has ground at most @maxDistance below it, freezing it anywhere else leaves it in mid-air */
+	bool IsCorpseNearGround(float maxDistance) const;
+
+	/** Stops the dead body where it lies, for UEnemyCorpseSubsystem when too many corpses simulate */
+	void FreezeCorpse();
+
+	/** Hides the enemy, stops its brain, collision and ticking so the pool can keep it around */
+	virtual void DeactivateForPool();
+
+	/** Brings a pooled enemy back at @transform with fresh stats and health */
+	virtual void ActivateFromPool(const FTransform& transform);
+
+	/**
+	 * The pool handed this enemy out for a new life, BeginPlay doesn't run again. deathEvent and hpZeroEvent are
+	 * cleared when the previous life despawned, whatever bound them in BeginPlay has to bind them again here.
+	 * Not called when UEnemyCrowdSubsystem brings back an enemy it demoted, that one is still in the same life.
+	 */
+	UFUNCTION(BlueprintImplementableEvent)
+	void OnActivatedFromPool();
+
+	bool IsPooled() const
+	{
+		return bPooled;
+	}
+
+	/** Set by the pool before FinishSpawning, the enemy goes straight to sleep in BeginPlay */
+	bool bStartPooled = false;
+
+	/** Whether Tick does anything for this enemy right now, AEnemyBase only ticks for a Blueprint Event Tick */
+	virtual bool NeedsActorTick() const;
+
+	/** Enemies the player is interacting with stay at full rate no matter where they are */
+	virtual bool NeedsFullTickRate() const
+	{
+		return false;
+	}
+
+	/** Called by UEnemySignificanceSubsystem, throttles actor, movement, mesh and AI ticking to @tickInterval */
+	void ApplySignificance(EEnemySignificance newSignificance, float tickInterval);
+
+	FName GetEnemyName() const
+	{
+		return enemyName;
+	}
+
+	int32 GetEnemyTypeId() const
+	{
+		return enemyTypeId;
+	}
+
+	class UStaticMesh* GetCrowdMesh() const
+	{
+		return crowdMesh;
+	}
+
 protected:
 
 	UFUNCTION()
 	virtual void SetupStats();
 
-	UFUNCTION()
-	void ApplyArmStayDamage();
+	void ApplyStats(const struct FEnemyStatData& enemyStatData);
 
-	UFUNCTION(BlueprintCallable)
-	void FinishAttack();
+#if WITH_EDITOR
+	void OnStatsReloaded();
+	FDelegateHandle statsReloadedHandle;
+#endif
 
-	UPROPERTY()
-	bool bAttackFinished;
+	/** The only Blueprint call of an attack, once per phase change. The hits belong in Active */
+	UFUNCTION(BlueprintNativeEvent)
+	void OnAttackPhaseChanged(EEnemyAttackPhase newPhase, AActor* target);
+
+	void SetAttackPhase(EEnemyAttackPhase newPhase);
+
+	float GetAttackPhaseDuration(EEnemyAttackPhase phase) const;
+
+	/** Reports the death to the actor registry and broadcasts hpZeroEvent */
+	void BroadcastHPZero();
+
+	/** deathEvent, only when a Blueprint bound it */
+	void BroadcastDeath();
 
 	UPROPERTY()
 	bool bIsGrabbable;
@@ -107,6 +234,21 @@ protected:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite)
 	float attackRange;
 
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Attack", meta = (ClampMin = "0.0"))
+	float attackWindupTime = 0.3f;
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Attack", meta = (ClampMin = "0.0"))
+	float attackActiveTime = 0.2f;
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Attack", meta = (ClampMin = "0.0"))
+	float attackRecoveryTime = 0.3f;
+
+	EEnemyAttackPhase attackPhase = EEnemyAttackPhase::Idle;
+
+	float attackPhaseTimeLeft = 0.f;
+
+	TWeakObjectPtr<AActor> attackTarget;
+
 	UPROPERTY()
 	bool bIsDead = false;
 
@@ -127,12 +269,27 @@ protected:
 	UPROPERTY(EditAnywhere)
 	FGameplayTagContainer gameplayTags;
 
+	/** Stands in for the enemy while it is far away and simulated by UEnemyCrowdSubsystem, without one the enemy always stays an actor */
+	UPROPERTY(EditDefaultsOnly, Category = "Crowd")
+	class UStaticMesh* crowdMesh = nullptr;
+
 	UPROPERTY(BlueprintReadOnly, Category="EnemyStats")
 	class UDataTable* enemyStatsTable;
 
-	float armStayDamage = 0.f;
-	FTimerHandle periodicDamageHandle;
-	FTimerHandle deathTimerHandle;
+	/** Index of our row in UEnemyStatCache, resolved on the first SetupStats */
+	int32 enemyTypeId = INDEX_NONE;
+
+	UPROPERTY()
+	class UActorRegistrySubsystem* actorRegistry;
+
+	UPROPERTY()
+	FName defaultCollisionProfileName;
+
+	bool bPooled = false;
+
+	EEnemySignificance significance;
+
+	FEnemyPlayerSense playerSense;
 
 public:	
 	// Called every frame
@@ -0,0 +1,88 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Enemies/EnemyCorpseSubsystem.h"
+
+#include "Enemies/EnemyBase.h"
+
+void UEnemyCorpseSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	// room for a full budget plus the deaths of one bad frame
+	corpses.Reserve(maxCorpses * 2);
+}
+
+void UEnemyCorpseSubsystem::AddCorpse(AEnemyBase* enemy, float lifetime)
+{
+	if (enemy == nullptr)
+	{
+		return;
+	}
+
+	FCorpse& corpse = corpses.AddDefaulted_GetRef();
+	corpse.enemy = enemy;
+	corpse.timeLeft = lifetime;
+}
+
+void UEnemyCorpseSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	// keeps the death order, pooled enemies may even be alive again
+	corpses.RemoveAll([](const FCorpse& corpse)
+	{
+		AEnemyBase* enemy = corpse.enemy.Get();
+		return enemy == nullptr || enemy->IsPooled() || !enemy->IsDead();
+	});
+
+	// Handled after the walk, despawning changes the list
+	TArray<AEnemyBase*, TInlineAllocator<16>> expired;
+
+	const int32 overBudget = corpses.Num() - maxCorpses;
+	int32 simulatedCount = 0;
+	// newest first, they are the ones that keep simulating
+	for (int32 i = corpses.Num() - 1; i >= 0; i--)
+	{
+		FCorpse& corpse = corpses[i];
+		AEnemyBase* enemy = corpse.enemy.Get();
+
+		corpse.timeLeft -= DeltaTime;
+		if (corpse.timeLeft <= 0.f || i < overBudget)
+		{
+			expired.Add(enemy);
+			continue;
+		}
+
+		if (enemy->IsCorpseSimulating() && ++simulatedCount > maxSimulatedCorpses)
+		{
+			// frozen in the air it would hang there, it goes instead
+			if (enemy->IsCorpseNearGround(freezeGroundDistance))
+			{
+				enemy->FreezeCorpse();
+			}
+			else
+			{
+				expired.Add(enemy);
+			}
+		}
+	}
+
+	for (AEnemyBase* enemy : expired)
+	{
+		if (IsValid(enemy) && !enemy->IsPooled())
+		{
+			enemy->Despawn();
+		}
+	}
+}
+
+bool UEnemyCorpseSubsystem::IsTickable() const
+{
+	return corpses.Num() > 0;
+}
+
+TStatId UEnemyCorpseSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UEnemyCorpseSubsystem, STATGROUP_Tickables);
+}
@@ -0,0 +1,52 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "EnemyCorpseSubsystem.generated.h"
+
+class AEnemyBase;
+
+/**
+ * Dead enemies lying around until their deathTimeBeforeRespawn runs out, all timed from one tick instead of a
+ * timer per death. Only the newest maxSimulatedCorpses keep simulating, older bodies are frozen once they are
+ * on the ground and despawned if they are still flying, and past maxCorpses the oldest are despawned early, so
+ * an explosion chain doesn't swamp physics.
+ */
+UCLASS(Config = Game)
+class RCT_API UEnemyCorpseSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+
+	/** Despawns @enemy @lifetime seconds from now, or sooner if the corpse budget runs out */
+	void AddCorpse(AEnemyBase* enemy, float lifetime);
+
+	virtual void Tick(float DeltaTime) override;
+	virtual bool IsTickable() const override;
+	virtual TStatId GetStatId() const override;
+
+protected:
+	UPROPERTY(Config)
+	int32 maxSimulatedCorpses = 8;
+
+	UPROPERTY(Config)
+	int32 maxCorpses = 24;
+
+	/** How far above the ground a body may be and still get frozen instead of despawned */
+	UPROPERTY(Config)
+	float freezeGroundDistance = 30.f;
+
+private:
+	struct FCorpse
+	{
+		TWeakObjectPtr<AEnemyBase> enemy;
+		float timeLeft = 0.f;
+	};
+
+	/** In death order, oldest first */
+	TArray<FCorpse> corpses;
+};
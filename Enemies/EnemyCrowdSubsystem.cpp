@@ -0,0 +1,279 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Enemies/EnemyCrowdSubsystem.h"
+
+#include "Async/ParallelFor.h"
+#include "Components/CapsuleComponent.h"
+#include "Components/InstancedStaticMeshComponent.h"
+#include "Enemies/EnemyBase.h"
+#include "Enemies/EnemyFlowFieldSubsystem.h"
+#include "Enemies/EnemyPoolSubsystem.h"
+#include "Enemies/EnemyStatCache.h"
+#include "Enemies/EnemyStatData.h"
+#include "GameFramework/CharacterMovementComponent.h"
+#include "Kismet/GameplayStatics.h"
+#include "Systems/ActorRegistrySubsystem.h"
+
+void UEnemyCrowdSubsystem::Deinitialize()
+{
+	entries.Empty();
+	visuals.Empty();
+	visualsActor = nullptr;
+
+	Super::Deinitialize();
+}
+
+bool UEnemyCrowdSubsystem::AddCrowdEnemy(TSubclassOf<AEnemyBase> enemyClass, const FTransform& transform)
+{
+	FCrowdEnemy entry;
+	if (!MakeEntry(enemyClass, transform, entry))
+	{
+		return false;
+	}
+	entries.Add(entry);
+
+	if (UActorRegistrySubsystem* registry = GetWorld()->GetSubsystem<UActorRegistrySubsystem>())
+	{
+		registry->AddCrowdEnemy();
+	}
+	return true;
+}
+
+void UEnemyCrowdSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	APawn* player = UGameplayStatics::GetPlayerPawn(GetWorld(), 0);
+	if (player == nullptr)
+	{
+		return;
+	}
+	const FVector playerLocation = player->GetActorLocation();
+
+	timeUntilDemotePass -= DeltaTime;
+	if (timeUntilDemotePass <= 0.f)
+	{
+		timeUntilDemotePass = demoteInterval;
+		DemoteFarEnemies(playerLocation);
+	}
+
+	// entries stay on the ground plane they were at, the arena floors are flat
+	const UEnemyFlowFieldSubsystem* flowField = GetWorld()->GetSubsystem<UEnemyFlowFieldSubsystem>();
+	const float promoteDistanceSquared = FMath::Square(promoteDistance);
+	ParallelFor(entries.Num(), [this, flowField, &playerLocation, promoteDistanceSquared, DeltaTime](int32 i)
+	{
+		FCrowdEnemy& entry = entries[i];
+
+		FVector toPlayer = playerLocation - entry.position;
+		toPlayer.Z = 0.f;
+		const float distanceSquared = toPlayer.SizeSquared();
+
+		if (distanceSquared <= FMath::Square(entry.pursueRadius))
+		{
+			const FVector direction = flowField ? flowField->GetDirectionToPlayer(entry.position) : toPlayer.GetSafeNormal();
+			entry.velocity = direction * entry.speed;
+		}
+		else
+		{
+			entry.velocity = FVector::ZeroVector;
+		}
+		entry.position += entry.velocity * DeltaTime;
+		entry.bWantsPromotion = distanceSquared <= promoteDistanceSquared;
+	});
+
+	PromoteEntries();
+	UpdateVisuals();
+}
+
+TStatId UEnemyCrowdSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UEnemyCrowdSubsystem, STATGROUP_Tickables);
+}
+
+bool UEnemyCrowdSubsystem::MakeEntry(TSubclassOf<AEnemyBase> enemyClass, const FTransform& transform, FCrowdEnemy& outEntry)
+{
+	if (!enemyClass)
+	{
+		return false;
+	}
+
+	const AEnemyBase* defaults = enemyClass->GetDefaultObject<AEnemyBase>();
+	if (defaults->GetCrowdMesh() == nullptr)
+	{
+		return false;
+	}
+
+	outEntry.enemyClass = enemyClass;
+	outEntry.position = transform.GetLocation();
+	outEntry.health = defaults->GetMaxHealth();
+	outEntry.speed = defaults->GetCharacterMovement()->MaxWalkSpeed;
+	outEntry.pursueRadius = defaults->GetPursueRadius();
+
+	UGameInstance* gameInstance = GetWorld()->GetGameInstance();
+	UEnemyStatCache* statCache = gameInstance ? gameInstance->GetSubsystem<UEnemyStatCache>() : nullptr;
+	if (statCache)
+	{
+		outEntry.typeId = statCache->ResolveTypeId(enemyClass, defaults->GetEnemyName());
+		if (const FEnemyStatData* enemyStatData = statCache->GetStats(outEntry.typeId))
+		{
+			outEntry.speed = enemyStatData->Speed;
+			outEntry.pursueRadius = enemyStatData->PursuitRadius;
+		}
+	}
+	return true;
+}
+
+void UEnemyCrowdSubsystem::DemoteFarEnemies(const FVector& playerLocation)
+{
+	UActorRegistrySubsystem* registry = GetWorld()->GetSubsystem<UActorRegistrySubsystem>();
+	if (registry == nullptr)
+	{
+		return;
+	}
+
+	registry->GetLiveEnemies(enemies);
+
+	const float demoteDistanceSquared = FMath::Square(demoteDistance);
+	for (AEnemyBase* enemy : enemies)
+	{
+		if (enemy->IsPooled() || FVector::DistSquared(playerLocation, enemy->GetActorLocation()) < demoteDistanceSquared)
+		{
+			continue;
+		}
+
+		// only enemies walking about on their own, nothing held, thrown, ragdolling or dying
+		if (enemy->IsDead() || enemy->GetHealth() <= 0.f || enemy->NeedsFullTickRate()
+			|| enemy->GetCapsuleComponent()->IsSimulatingPhysics() || !enemy->GetCharacterMovement()->IsMovingOnGround())
+		{
+			continue;
+		}
+
+		FCrowdEnemy entry;
+		if (!MakeEntry(enemy->GetClass(), enemy->GetActorTransform(), entry))
+		{
+			continue;
+		}
+		entry.health = enemy->GetHealth();
+		entry.velocity = enemy->GetVelocity();
+		entry.actor = enemy;
+
+		// asleep like a pooled enemy, but not handed to the pool, which would give it to another spawn
+		registry->MoveEnemyToCrowd(enemy);
+		enemy->DeactivateForPool();
+		entries.Add(entry);
+	}
+}
+
+void UEnemyCrowdSubsystem::PromoteEntries()
+{
+	UEnemyPoolSubsystem* pool = GetWorld()->GetSubsystem<UEnemyPoolSubsystem>();
+	UActorRegistrySubsystem* registry = GetWorld()->GetSubsystem<UActorRegistrySubsystem>();
+
+	int32 promotions = 0;
+	for (int32 i = entries.Num() - 1; i >= 0 && promotions < maxPromotionsPerFrame; i--)
+	{
+		const FCrowdEnemy& entry = entries[i];
+		if (!entry.bWantsPromotion)
+		{
+			continue;
+		}
+
+		const FRotator facing = entry.velocity.IsNearlyZero() ? FRotator::ZeroRotator : entry.velocity.Rotation();
+		const FTransform transform(facing, entry.position);
+
+		// the actor we demoted wakes up again, entries spawned into the crowd get one from the pool
+		AEnemyBase* enemy = entry.actor.Get();
+		if (IsValid(enemy) && enemy->IsPooled())
+		{
+			enemy->ActivateFromPool(transform);
+		}
+		else
+		{
+			enemy = pool ? pool->SpawnEnemy(entry.enemyClass, transform) : nullptr;
+		}
+		if (enemy == nullptr)
+		{
+			continue;
+		}
+		promotions++;
+
+		if (registry)
+		{
+			registry->MoveEnemyOutOfCrowd();
+		}
+
+		// the pool hands it out at full health, carry over what the entry had left
+		enemy->ModifyHealth(entry.health - enemy->GetHealth());
+		enemy->GetCharacterMovement()->Velocity = entry.velocity;
+
+		entries.RemoveAtSwap(i);
+	}
+}
+
+void UEnemyCrowdSubsystem::UpdateVisuals()
+{
+	for (auto& visual : visuals)
+	{
+		visual.Value.transforms.Reset();
+	}
+
+	for (const FCrowdEnemy& entry : entries)
+	{
+		const FRotator facing = entry.velocity.IsNearlyZero() ? FRotator::ZeroRotator : entry.velocity.Rotation();
+		FindOrAddVisual(entry.enemyClass).transforms.Emplace(facing, entry.position);
+	}
+
+	for (auto& pair : visuals)
+	{
+		FEnemyCrowdVisual& visual = pair.Value;
+		if (!IsValid(visual.instances))
+		{
+			continue;
+		}
+
+		// the instance count only changes on promotion and demotion, every other frame just moves them
+		if (visual.instances->GetInstanceCount() == visual.transforms.Num())
+		{
+			if (visual.transforms.Num() > 0)
+			{
+				visual.instances->BatchUpdateInstancesTransforms(0, visual.transforms, true, true, true);
+			}
+		}
+		else
+		{
+			visual.instances->ClearInstances();
+			visual.instances->AddInstances(visual.transforms, false, true);
+		}
+	}
+}
+
+FEnemyCrowdVisual& UEnemyCrowdSubsystem::FindOrAddVisual(UClass* enemyClass)
+{
+	if (FEnemyCrowdVisual* visual = visuals.Find(enemyClass))
+	{
+		return *visual;
+	}
+
+	if (visualsActor == nullptr)
+	{
+		FActorSpawnParameters spawnParams;
+		spawnParams.ObjectFlags |= RF_Transient;
+		visualsActor = GetWorld()->SpawnActor<AActor>(AActor::StaticClass(), FTransform::Identity, spawnParams);
+	}
+
+	UInstancedStaticMeshComponent* instances = NewObject<UInstancedStaticMeshComponent>(visualsActor);
+	instances->SetMobility(EComponentMobility::Movable);
+	instances->SetStaticMesh(enemyClass->GetDefaultObject<AEnemyBase>()->GetCrowdMesh());
+	instances->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+	if (visualsActor->GetRootComponent() == nullptr)
+	{
+		visualsActor->SetRootComponent(instances);
+	}
+	instances->RegisterComponent();
+	visualsActor->AddInstanceComponent(instances);
+
+	FEnemyCrowdVisual& visual = visuals.Add(enemyClass);
+	visual.instances = instances;
+	return visual;
+}
@@ -0,0 +1,108 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "EnemyCrowdSubsystem.generated.h"
+
+class AEnemyBase;
+class UInstancedStaticMeshComponent;
+
+USTRUCT()
+struct FEnemyCrowdVisual
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	UInstancedStaticMeshComponent* instances = nullptr;
+
+	/** Filled every frame from the entries of this class */
+	TArray<FTransform> transforms;
+};
+
+/**
+ * Far away enemies as plain data instead of characters, so a room can hold hundreds of them.
+ * Entries walk towards the player in a ParallelFor and are drawn with one instanced mesh per enemy class
+ * (AEnemyBase::crowdMesh). They get promoted to pooled actors when they come close to the player, and live
+ * enemies far enough away get demoted back to entries. A demoted enemy's actor is put to sleep and kept by its
+ * entry instead of going back to the pool, and that same actor comes back on promotion, so its per-instance
+ * settings and event bindings survive. Crowd entries count towards the room like any enemy.
+ */
+UCLASS(Config = Game)
+class RCT_API UEnemyCrowdSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Deinitialize() override;
+
+	/** Adds an enemy of @enemyClass straight into the crowd, it only becomes an actor once the player comes near */
+	UFUNCTION(BlueprintCallable)
+	bool AddCrowdEnemy(TSubclassOf<AEnemyBase> enemyClass, const FTransform& transform);
+
+	UFUNCTION(BlueprintCallable, BlueprintPure)
+	int32 GetCrowdCount() const
+	{
+		return entries.Num();
+	}
+
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+protected:
+	/** Entries closer than this to the player become actors */
+	UPROPERTY(Config)
+	float promoteDistance = 3000.f;
+
+	/** Actors further than this get demoted, keep it above promoteDistance so enemies don't flicker between the two */
+	UPROPERTY(Config)
+	float demoteDistance = 4000.f;
+
+	/** Seconds between two passes looking for actors to demote */
+	UPROPERTY(Config)
+	float demoteInterval = 0.5f;
+
+	/** Promotions spawn actors, spread them over frames when a horde walks in */
+	UPROPERTY(Config)
+	int32 maxPromotionsPerFrame = 4;
+
+private:
+	struct FCrowdEnemy
+	{
+		TSubclassOf<AEnemyBase> enemyClass;
+		/** The actor this entry was demoted from, asleep until the entry gets promoted, null for spawned entries */
+		TWeakObjectPtr<AEnemyBase> actor;
+		int32 typeId = INDEX_NONE;
+		FVector position = FVector::ZeroVector;
+		FVector velocity = FVector::ZeroVector;
+		float health = 0.f;
+		float speed = 0.f;
+		float pursueRadius = 0.f;
+		bool bWantsPromotion = false;
+	};
+
+	/** Entry for @enemyClass at @transform with full health and the stats of its row, false if it has no crowd mesh */
+	bool MakeEntry(TSubclassOf<AEnemyBase> enemyClass, const FTransform& transform, FCrowdEnemy& outEntry);
+
+	void DemoteFarEnemies(const FVector& playerLocation);
+
+	void PromoteEntries();
+
+	void UpdateVisuals();
+
+	FEnemyCrowdVisual& FindOrAddVisual(UClass* enemyClass);
+
+	TArray<FCrowdEnemy> entries;
+
+	UPROPERTY()
+	TMap<UClass*, FEnemyCrowdVisual> visuals;
+
+	/** Owner of the instanced mesh components */
+	UPROPERTY()
+	AActor* visualsActor = nullptr;
+
+	float timeUntilDemotePass = 0.f;
+
+	TArray<AEnemyBase*> enemies;
+};
@@ -0,0 +1,262 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Enemies/EnemyFlowFieldSubsystem.h"
+
+#include "Kismet/GameplayStatics.h"
+#include "NavigationSystem.h"
+
+namespace
+{
+	const FIntPoint NeighbourOffsets[] =
+	{
+		FIntPoint(1, 0), FIntPoint(-1, 0), FIntPoint(0, 1), FIntPoint(0, -1),
+		FIntPoint(1, 1), FIntPoint(1, -1), FIntPoint(-1, 1), FIntPoint(-1, -1),
+	};
+
+	const float DiagonalCost = FMath::Sqrt(2.f);
+}
+
+void UEnemyFlowFieldSubsystem::Deinitialize()
+{
+	distances.Empty();
+	walkableCells.Empty();
+	pendingCells.Empty();
+
+	Super::Deinitialize();
+}
+
+void UEnemyFlowFieldSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	APawn* player = UGameplayStatics::GetPlayerPawn(GetWorld(), 0);
+	if (player == nullptr)
+	{
+		return;
+	}
+	playerLocation = player->GetActorLocation();
+
+	if (ResolvePendingCells())
+	{
+		bFieldDirty = true;
+	}
+
+	timeUntilRebuild -= DeltaTime;
+	const FIntPoint newPlayerCell = ToCell(playerLocation);
+	if ((newPlayerCell != playerCell || bFieldDirty) && timeUntilRebuild <= 0.f)
+	{
+		timeUntilRebuild = rebuildInterval;
+		UpdatePlayerBand(player);
+		Rebuild(newPlayerCell);
+	}
+}
+
+TStatId UEnemyFlowFieldSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UEnemyFlowFieldSubsystem, STATGROUP_Tickables);
+}
+
+FVector UEnemyFlowFieldSubsystem::GetDirectionToPlayer(const FVector& location) const
+{
+	const FVector straight = (playerLocation - location).GetSafeNormal2D();
+
+	const FIntPoint cell = ToCell(location);
+	const int32 index = ToIndex(cell);
+	if (index == INDEX_NONE || cell == playerCell || distances[index] == MAX_flt)
+	{
+		return straight;
+	}
+
+	float bestDistance = distances[index];
+	FIntPoint bestCell = cell;
+	for (const FIntPoint& offset : NeighbourOffsets)
+	{
+		const int32 neighbour = ToIndex(cell + offset);
+		if (neighbour == INDEX_NONE || distances[neighbour] >= bestDistance)
+		{
+			continue;
+		}
+
+		// no cutting corners past a wall
+		if (offset.X != 0 && offset.Y != 0)
+		{
+			const int32 sideA = ToIndex(cell + FIntPoint(offset.X, 0));
+			const int32 sideB = ToIndex(cell + FIntPoint(0, offset.Y));
+			if (sideA == INDEX_NONE || sideB == INDEX_NONE || distances[sideA] == MAX_flt || distances[sideB] == MAX_flt)
+			{
+				continue;
+			}
+		}
+
+		bestDistance = distances[neighbour];
+		bestCell = cell + offset;
+	}
+
+	if (bestCell == cell)
+	{
+		return straight;
+	}
+	return (CellCenter(bestCell, location.Z) - location).GetSafeNormal2D();
+}
+
+void UEnemyFlowFieldSubsystem::Rebuild(const FIntPoint& newPlayerCell)
+{
+	playerCell = newPlayerCell;
+	fieldSize = halfExtentCells * 2 + 1;
+	fieldOrigin = playerCell - FIntPoint(halfExtentCells, halfExtentCells);
+
+	const int32 cellCount = fieldSize * fieldSize;
+	distances.Init(MAX_flt, cellCount);
+	bFieldDirty = false;
+
+	// cells left over from the previous field are queued again if they are still in this one
+	pendingCells.Reset();
+	TArray<bool> walkable;
+	walkable.SetNumUninitialized(cellCount);
+	for (int32 i = 0; i < cellCount; i++)
+	{
+		walkable[i] = IsCellWalkable(fieldOrigin + FIntPoint(i % fieldSize, i / fieldSize));
+	}
+
+	// popped off the end, the cells enemies near the player walk through get projected first
+	pendingCells.Sort([this](const FIntVector& a, const FIntVector& b)
+	{
+		return (FIntPoint(a.X, a.Y) - playerCell).SizeSquared() > (FIntPoint(b.X, b.Y) - playerCell).SizeSquared();
+	});
+
+	// Dijkstra from the player cell over the walkable cells, 8 neighbours
+	auto byDistance = [](const TPair<float, int32>& a, const TPair<float, int32>& b)
+	{
+		return a.Key < b.Key;
+	};
+	TArray<TPair<float, int32>> open;
+
+	const int32 playerIndex = ToIndex(playerCell);
+	distances[playerIndex] = 0.f;
+	open.HeapPush(TPair<float, int32>(0.f, playerIndex), byDistance);
+
+	while (open.Num() > 0)
+	{
+		TPair<float, int32> current;
+		open.HeapPop(current, byDistance, false);
+		if (current.Key > distances[current.Value])
+		{
+			continue;
+		}
+
+		const FIntPoint cell = fieldOrigin + FIntPoint(current.Value % fieldSize, current.Value / fieldSize);
+		for (const FIntPoint& offset : NeighbourOffsets)
+		{
+			const int32 neighbour = ToIndex(cell + offset);
+			if (neighbour == INDEX_NONE || !walkable[neighbour])
+			{
+				continue;
+			}
+
+			const bool bDiagonal = offset.X != 0 && offset.Y != 0;
+			if (bDiagonal)
+			{
+				const int32 sideA = ToIndex(cell + FIntPoint(offset.X, 0));
+				const int32 sideB = ToIndex(cell + FIntPoint(0, offset.Y));
+				if (sideA == INDEX_NONE || sideB == INDEX_NONE || !walkable[sideA] || !walkable[sideB])
+				{
+					continue;
+				}
+			}
+
+			const float distance = current.Key + (bDiagonal ? DiagonalCost : 1.f) * cellSize;
+			if (distance < distances[neighbour])
+			{
+				distances[neighbour] = distance;
+				open.HeapPush(TPair<float, int32>(distance, neighbour), byDistance);
+			}
+		}
+	}
+}
+
+bool UEnemyFlowFieldSubsystem::IsCellWalkable(const FIntPoint& cell)
+{
+	// floors stacked above each other share a cell, not a band
+	const FIntVector key(cell.X, cell.Y, playerBand);
+	if (const bool* cached = walkableCells.Find(key))
+	{
+		return *cached;
+	}
+
+	pendingCells.Add(key);
+	return true;
+}
+
+bool UEnemyFlowFieldSubsystem::ResolvePendingCells()
+{
+	if (pendingCells.Num() == 0)
+	{
+		return false;
+	}
+
+	// no navmesh (yet), everything stays walkable and the next rebuild queues the cells again
+	UNavigationSystemV1* navSystem = FNavigationSystem::GetCurrent<UNavigationSystemV1>(GetWorld());
+	if (navSystem == nullptr || navSystem->GetDefaultNavDataInstance() == nullptr)
+	{
+		return false;
+	}
+
+	bool bFoundBlocked = false;
+	const FVector extent(cellSize * 0.5f, cellSize * 0.5f, navProjectionHeight);
+	for (int32 i = 0; i < maxProjectionsPerFrame && pendingCells.Num() > 0; i++)
+	{
+		const FIntVector key = pendingCells.Pop(false);
+		if (walkableCells.Contains(key))
+		{
+			continue;
+		}
+
+		// projected from the band's centre so the cached result doesn't depend on where in the band we asked from
+		FNavLocation navLocation;
+		const bool bWalkable = navSystem->ProjectPointToNavigation(CellCenter(FIntPoint(key.X, key.Y), key.Z * navProjectionHeight), navLocation, extent);
+		walkableCells.Add(key, bWalkable);
+		bFoundBlocked |= !bWalkable;
+	}
+	return bFoundBlocked;
+}
+
+void UEnemyFlowFieldSubsystem::UpdatePlayerBand(APawn* player)
+{
+	// the floor, not the capsule, a jump shouldn't move the field to another band
+	float floorHeight = playerLocation.Z - player->GetSimpleCollisionHalfHeight();
+	UNavigationSystemV1* navSystem = FNavigationSystem::GetCurrent<UNavigationSystemV1>(GetWorld());
+	FNavLocation navLocation;
+	if (navSystem && navSystem->GetDefaultNavDataInstance()
+		&& navSystem->ProjectPointToNavigation(playerLocation, navLocation, FVector(cellSize * 0.5f, cellSize * 0.5f, navProjectionHeight)))
+	{
+		floorHeight = navLocation.Location.Z;
+	}
+
+	// a floor close to a band's edge doesn't flip between the two, the band's projections still reach it
+	if (!bHasPlayerBand || FMath::Abs(floorHeight - playerBand * navProjectionHeight) > navProjectionHeight * 0.75f)
+	{
+		playerBand = FMath::RoundToInt(floorHeight / navProjectionHeight);
+		bHasPlayerBand = true;
+	}
+}
+
+FIntPoint UEnemyFlowFieldSubsystem::ToCell(const FVector& location) const
+{
+	return FIntPoint(FMath::FloorToInt(location.X / cellSize), FMath::FloorToInt(location.Y / cellSize));
+}
+
+FVector UEnemyFlowFieldSubsystem::CellCenter(const FIntPoint& cell, float height) const
+{
+	return FVector((cell.X + 0.5f) * cellSize, (cell.Y + 0.5f) * cellSize, height);
+}
+
+int32 UEnemyFlowFieldSubsystem::ToIndex(const FIntPoint& cell) const
+{
+	const FIntPoint local = cell - fieldOrigin;
+	if (local.X < 0 || local.Y < 0 || local.X >= fieldSize || local.Y >= fieldSize)
+	{
+		return INDEX_NONE;
+	}
+	return local.Y * fieldSize + local.X;
+}
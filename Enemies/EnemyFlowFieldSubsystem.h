@@ -0,0 +1,99 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "EnemyFlowFieldSubsystem.generated.h"
+
+/**
+ * One distance field around the player shared by every pursuing enemy, instead of a path query per enemy.
+ * The field is a grid of cells centred on the player, walkable where the navmesh is. The whole field is
+ * recomputed when the player moves to another cell, only the navmesh projections are kept between rebuilds,
+ * per cell and height band of the floor the player stands on. Cells not projected yet count as walkable and are
+ * projected a few per frame (maxProjectionsPerFrame), the field is rebuilt once they turn out blocked. Enemies
+ * sample it for the direction to walk in, the cost is the same for one or a hundred of them.
+ */
+UCLASS(Config = Game)
+class RCT_API UEnemyFlowFieldSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Deinitialize() override;
+
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	/**
+	 * Horizontal direction to walk in from @location to reach the player around obstacles.
+	 * Outside the field, or on a cell the player can't be reached from, it points straight at the player.
+	 * Only reads the field, safe to call from worker threads while the game thread is not ticking the subsystem.
+	 */
+	UFUNCTION(BlueprintCallable, BlueprintPure)
+	FVector GetDirectionToPlayer(const FVector& location) const;
+
+protected:
+	UPROPERTY(Config)
+	float cellSize = 100.f;
+
+	/** The field spans this many cells from the player in each direction */
+	UPROPERTY(Config)
+	int32 halfExtentCells = 40;
+
+	/** How far above or below a cell centre the navmesh may be for the cell to count as walkable, also the height of a cache band */
+	UPROPERTY(Config)
+	float navProjectionHeight = 200.f;
+
+	/** Minimum seconds between two rebuilds when the player keeps changing cells */
+	UPROPERTY(Config)
+	float rebuildInterval = 0.1f;
+
+	/** Navmesh projections of uncached cells per frame, the first field alone needs thousands */
+	UPROPERTY(Config)
+	int32 maxProjectionsPerFrame = 200;
+
+private:
+	void Rebuild(const FIntPoint& newPlayerCell);
+
+	/** Cached projection of @cell in the player's band, walkable and queued for projection when unknown */
+	bool IsCellWalkable(const FIntPoint& cell);
+
+	/** Projects up to maxProjectionsPerFrame queued cells, true if one of the field's turned out blocked */
+	bool ResolvePendingCells();
+
+	/** Height band of the floor below the player, it only changes once the floor is well into another band */
+	void UpdatePlayerBand(APawn* player);
+
+	FIntPoint ToCell(const FVector& location) const;
+
+	FVector CellCenter(const FIntPoint& cell, float height) const;
+
+	/** Index in distances of @cell, INDEX_NONE outside the field */
+	int32 ToIndex(const FIntPoint& cell) const;
+
+	/** Walking distance to the player per cell, MAX_flt where it can't be reached */
+	TArray<float> distances;
+
+	/** Cell of the field's first entry */
+	FIntPoint fieldOrigin = FIntPoint::ZeroValue;
+	int32 fieldSize = 0;
+
+	FIntPoint playerCell = FIntPoint(MAX_int32, MAX_int32);
+	FVector playerLocation = FVector::ZeroVector;
+
+	/** Navmesh projection result per world cell and height band (Z), the level geometry doesn't move */
+	TMap<FIntVector, bool> walkableCells;
+
+	/** Cells of the field with no projection yet, closest to the player last */
+	TArray<FIntVector> pendingCells;
+
+	/** Band of the player's floor, band N is centred on N * navProjectionHeight */
+	int32 playerBand = 0;
+	bool bHasPlayerBand = false;
+
+	/** A queued cell of the current field turned out blocked */
+	bool bFieldDirty = false;
+
+	float timeUntilRebuild = 0.f;
+};
@@ -0,0 +1,186 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Enemies/EnemyMovementComponent.h"
+
+#include "AI/Navigation/NavigationDataInterface.h"
+#include "Components/CapsuleComponent.h"
+#include "Enemies/EnemySpatialHashSubsystem.h"
+#include "GameFramework/Character.h"
+
+void UEnemyMovementComponent::BeginPlay()
+{
+	Super::BeginPlay();
+
+	if (bUseSimpleMovement)
+	{
+		if (UEnemySpatialHashSubsystem* spatialHash = GetWorld()->GetSubsystem<UEnemySpatialHashSubsystem>())
+		{
+			spatialHash->AddAgent(this);
+		}
+	}
+}
+
+void UEnemyMovementComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (UEnemySpatialHashSubsystem* spatialHash = GetWorld()->GetSubsystem<UEnemySpatialHashSubsystem>())
+	{
+		spatialHash->RemoveAgent(this);
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
+
+void UEnemyMovementComponent::SetUseSimpleMovement(bool bUse)
+{
+	if (bUseSimpleMovement == bUse)
+	{
+		return;
+	}
+	bUseSimpleMovement = bUse;
+	bHasLastNavLocation = false;
+
+	if (!HasBegunPlay())
+	{
+		return;
+	}
+
+	if (UEnemySpatialHashSubsystem* spatialHash = GetWorld()->GetSubsystem<UEnemySpatialHashSubsystem>())
+	{
+		if (bUseSimpleMovement)
+		{
+			spatialHash->AddAgent(this);
+		}
+		else
+		{
+			spatialHash->RemoveAgent(this);
+		}
+	}
+}
+
+void UEnemyMovementComponent::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
+{
+	if (!CanUseSimpleMovement())
+	{
+		// wherever the full movement leaves us, it isn't the last simple move's location anymore
+		bHasLastNavLocation = false;
+		Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+		return;
+	}
+
+	// skips the character movement tick, only the base movement component bookkeeping runs
+	UPawnMovementComponent::TickComponent(DeltaTime, TickType, ThisTickFunction);
+	if (ShouldSkipUpdate(DeltaTime))
+	{
+		return;
+	}
+
+	SimpleMove(DeltaTime);
+}
+
+bool UEnemyMovementComponent::CanUseSimpleMovement() const
+{
+	if (!bUseSimpleMovement || UpdatedComponent == nullptr || CharacterOwner == nullptr)
+	{
+		return false;
+	}
+
+	if (MovementMode != MOVE_Walking && MovementMode != MOVE_NavWalking)
+	{
+		return false;
+	}
+
+	if (GetNavData() == nullptr)
+	{
+		return false;
+	}
+
+	// held by the arm, thrown, launched or animation driven
+	return UpdatedComponent->GetAttachParent() == nullptr
+		&& !UpdatedComponent->IsSimulatingPhysics()
+		&& PendingLaunchVelocity.IsZero()
+		&& !HasAnimRootMotion()
+		&& !CurrentRootMotion.HasActiveRootMotionSources();
+}
+
+void UEnemyMovementComponent::SimpleMove(float DeltaTime)
+{
+	// path following requests a velocity, MoveAlongFlowField and Blueprints add input
+	FVector desiredVelocity;
+	if (bHasRequestedVelocity)
+	{
+		desiredVelocity = RequestedVelocity;
+		bHasRequestedVelocity = false;
+		ConsumeInputVector();
+	}
+	else
+	{
+		desiredVelocity = ConsumeInputVector().GetClampedToMaxSize(1.f) * MaxWalkSpeed;
+	}
+	desiredVelocity.Z = 0.f;
+
+	const FVector location = UpdatedComponent->GetComponentLocation();
+	if (const UEnemySpatialHashSubsystem* spatialHash = GetWorld()->GetSubsystem<UEnemySpatialHashSubsystem>())
+	{
+		desiredVelocity += spatialHash->GetSeparation(this, location, separationRadius) * separationSpeed;
+	}
+	desiredVelocity = desiredVelocity.GetClampedToMaxSize2D(MaxWalkSpeed);
+
+	Velocity.Z = 0.f;
+	Velocity = FMath::VInterpConstantTo(Velocity, desiredVelocity, DeltaTime, MaxAcceleration);
+	if (Velocity.IsNearlyZero())
+	{
+		Velocity = FVector::ZeroVector;
+		UpdateComponentVelocity();
+		return;
+	}
+
+	FRotator rotation = UpdatedComponent->GetComponentRotation();
+	if (bOrientRotationToMovement)
+	{
+		rotation = FMath::RInterpConstantTo(rotation, FRotator(0.f, Velocity.Rotation().Yaw, 0.f), DeltaTime, RotationRate.Yaw);
+	}
+
+	// the horizontal move is swept so walls and the player block us, sliding along them like a walking character
+	const FVector delta = Velocity * DeltaTime;
+	FHitResult hit;
+	SafeMoveUpdatedComponent(delta, rotation.Quaternion(), true, hit);
+	if (hit.IsValidBlockingHit())
+	{
+		SlideAlongSurface(delta, 1.f - hit.Time, hit.Normal, hit, true);
+	}
+
+	// stay on the navmesh instead of sweeping for the floor, a move off its edge goes back to the last location on it
+	const float halfHeight = CharacterOwner->GetCapsuleComponent()->GetScaledCapsuleHalfHeight();
+	const FVector movedLocation = UpdatedComponent->GetComponentLocation();
+	FNavLocation navLocation;
+	if (!GetNavData()->ProjectPoint(movedLocation - FVector(0.f, 0.f, halfHeight), navLocation, FVector(10.f, 10.f, MaxStepHeight)))
+	{
+		// no location on the navmesh to go back to (just spawned, woken from the pool or landed), the full
+		// movement finds the floor from here, walking on at this height would leave us in mid-air
+		if (!bHasLastNavLocation)
+		{
+			SetMovementMode(MOVE_Falling);
+			UpdateComponentVelocity();
+			return;
+		}
+
+		MoveUpdatedComponent(lastNavLocation - movedLocation, UpdatedComponent->GetComponentQuat(), false);
+		Velocity = FVector::ZeroVector;
+		UpdateComponentVelocity();
+		return;
+	}
+
+	// only the height is snapped, not swept, the navmesh is where the floor is
+	lastNavLocation = FVector(movedLocation.X, movedLocation.Y, navLocation.Location.Z + halfHeight);
+	bHasLastNavLocation = true;
+	MoveUpdatedComponent(lastNavLocation - movedLocation, UpdatedComponent->GetComponentQuat(), false);
+
+	// blocked moves don't keep pushing into what blocked them
+	if (DeltaTime > 0.f)
+	{
+		Velocity = FVector((lastNavLocation - location) / DeltaTime).GetClampedToMaxSize2D(MaxWalkSpeed);
+		Velocity.Z = 0.f;
+	}
+	UpdateComponentVelocity();
+}
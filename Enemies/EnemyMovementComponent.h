@@ -0,0 +1,56 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/CharacterMovementComponent.h"
+#include "EnemyMovementComponent.generated.h"
+
+/**
+ * Character movement of every enemy, with an opt-in cheap path for walking on flat floors.
+ * With bUseSimpleMovement the enemy sweeps in 2D and is kept on the navmesh by projection, with no floor sweeps,
+ * step ups or movement mode state machine, and keeps its distance from its neighbours through
+ * UEnemySpatialHashSubsystem. A move that leaves the navmesh stops at the last location on it. Falling,
+ * launched, thrown, attached or root motion driven enemies, or levels without a navmesh, always get the full
+ * character movement.
+ */
+UCLASS()
+class RCT_API UEnemyMovementComponent : public UCharacterMovementComponent
+{
+	GENERATED_BODY()
+
+public:
+	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+	virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
+
+	float GetSeparationRadius() const
+	{
+		return separationRadius;
+	}
+
+	/** Switches simple movement at runtime, keeping the spatial hash registration in sync */
+	UFUNCTION(BlueprintCallable, Category = "Simple Movement")
+	void SetUseSimpleMovement(bool bUse);
+
+protected:
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Simple Movement")
+	bool bUseSimpleMovement = false;
+
+	/** Neighbours closer than the sum of both radii push each other apart */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Simple Movement", meta = (EditCondition = "bUseSimpleMovement"))
+	float separationRadius = 60.f;
+
+	/** Speed added away from a neighbour we fully overlap */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Simple Movement", meta = (EditCondition = "bUseSimpleMovement"))
+	float separationSpeed = 300.f;
+
+private:
+	bool CanUseSimpleMovement() const;
+
+	void SimpleMove(float DeltaTime);
+
+	/** Where the last simple move ended on the navmesh, where we go back to when one leaves it */
+	FVector lastNavLocation = FVector::ZeroVector;
+	bool bHasLastNavLocation = false;
+};
@@ -0,0 +1,170 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Enemies/EnemyPerceptionSubsystem.h"
+
+#include "AIController.h"
+#include "BehaviorTree/Blackboard/BlackboardKeyType_Bool.h"
+#include "BehaviorTree/Blackboard/BlackboardKeyType_Float.h"
+#include "BehaviorTree/BlackboardData.h"
+#include "Enemies/EnemyBase.h"
+#include "Kismet/GameplayStatics.h"
+#include "Systems/ActorRegistrySubsystem.h"
+
+void UEnemyPerceptionSubsystem::Deinitialize()
+{
+	enemies.Empty();
+	blackboardKeys.Empty();
+
+	Super::Deinitialize();
+}
+
+void UEnemyPerceptionSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	UActorRegistrySubsystem* registry = GetWorld()->GetSubsystem<UActorRegistrySubsystem>();
+	APawn* player = UGameplayStatics::GetPlayerPawn(GetWorld(), 0);
+	if (registry == nullptr || player == nullptr)
+	{
+		return;
+	}
+
+	registry->GetLiveEnemies(enemies);
+	const int32 count = enemies.Num();
+	if (count == 0)
+	{
+		return;
+	}
+
+	positionsX.SetNumUninitialized(count, false);
+	positionsY.SetNumUninitialized(count, false);
+	positionsZ.SetNumUninitialized(count, false);
+	pursueRadiiSquared.SetNumUninitialized(count, false);
+	attackRangesSquared.SetNumUninitialized(count, false);
+	distancesSquared.SetNumUninitialized(count, false);
+
+	for (int32 i = 0; i < count; i++)
+	{
+		const FVector location = enemies[i]->GetActorLocation();
+		positionsX[i] = location.X;
+		positionsY[i] = location.Y;
+		positionsZ[i] = location.Z;
+		pursueRadiiSquared[i] = FMath::Square(enemies[i]->GetPursueRadius());
+		attackRangesSquared[i] = FMath::Square(enemies[i]->GetAttackRange());
+	}
+
+	// straight loop over flat arrays, the compiler vectorizes it
+	const FVector playerLocation = player->GetActorLocation();
+	const float playerX = playerLocation.X;
+	const float playerY = playerLocation.Y;
+	const float playerZ = playerLocation.Z;
+	float* RESTRICT outDistances = distancesSquared.GetData();
+	const float* RESTRICT xs = positionsX.GetData();
+	const float* RESTRICT ys = positionsY.GetData();
+	const float* RESTRICT zs = positionsZ.GetData();
+	for (int32 i = 0; i < count; i++)
+	{
+		const float dx = xs[i] - playerX;
+		const float dy = ys[i] - playerY;
+		const float dz = zs[i] - playerZ;
+		outDistances[i] = dx * dx + dy * dy + dz * dz;
+	}
+
+	traceCandidates.Reset();
+	for (int32 i = 0; i < count; i++)
+	{
+		if (distancesSquared[i] <= pursueRadiiSquared[i])
+		{
+			traceCandidates.Add(i);
+		}
+	}
+
+	// a few traces per frame, the others keep what they saw last time
+	TBitArray<> traced(false, count);
+	TBitArray<> visible(false, count);
+	const int32 traceCount = FMath::Min(maxTracesPerFrame, traceCandidates.Num());
+	for (int32 t = 0; t < traceCount; t++)
+	{
+		const int32 i = traceCandidates[(traceCursor + t) % traceCandidates.Num()];
+		traced[i] = true;
+		visible[i] = TraceLineOfSight(enemies[i], player);
+	}
+	traceCursor = traceCandidates.Num() > 0 ? (traceCursor + traceCount) % traceCandidates.Num() : 0;
+
+	for (int32 i = 0; i < count; i++)
+	{
+		AEnemyBase* enemy = enemies[i];
+
+		FEnemyPlayerSense sense = enemy->GetPlayerSense();
+		sense.distance = FMath::Sqrt(distancesSquared[i]);
+		sense.bInPursueRange = distancesSquared[i] <= pursueRadiiSquared[i];
+		sense.bInAttackRange = distancesSquared[i] <= attackRangesSquared[i];
+		if (!sense.bInPursueRange)
+		{
+			sense.bHasLineOfSight = false;
+		}
+		else if (traced[i])
+		{
+			sense.bHasLineOfSight = visible[i];
+		}
+
+		enemy->SetPlayerSense(sense);
+		WriteBlackboard(enemy, sense);
+	}
+}
+
+TStatId UEnemyPerceptionSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UEnemyPerceptionSubsystem, STATGROUP_Tickables);
+}
+
+bool UEnemyPerceptionSubsystem::TraceLineOfSight(AEnemyBase* enemy, APawn* player) const
+{
+	FVector eyeLocation;
+	FRotator eyeRotation;
+	enemy->GetActorEyesViewPoint(eyeLocation, eyeRotation);
+
+	FCollisionQueryParams params(SCENE_QUERY_STAT(EnemyLineOfSight), false, enemy);
+	params.AddIgnoredActor(player);
+	return !GetWorld()->LineTraceTestByChannel(eyeLocation, player->GetActorLocation(), ECC_Visibility, params);
+}
+
+void UEnemyPerceptionSubsystem::WriteBlackboard(AEnemyBase* enemy, const FEnemyPlayerSense& sense)
+{
+	AAIController* controller = Cast<AAIController>(enemy->GetController());
+	UBlackboardComponent* blackboard = controller ? controller->GetBlackboardComponent() : nullptr;
+	const UBlackboardData* blackboardAsset = blackboard ? blackboard->GetBlackboardAsset() : nullptr;
+	if (blackboardAsset == nullptr)
+	{
+		return;
+	}
+
+	FBlackboardKeys* keys = blackboardKeys.Find(blackboardAsset);
+	if (keys == nullptr)
+	{
+		keys = &blackboardKeys.Add(blackboardAsset);
+		keys->playerDistance = blackboardAsset->GetKeyID(playerDistanceKey);
+		keys->inPursueRange = blackboardAsset->GetKeyID(inPursueRangeKey);
+		keys->inAttackRange = blackboardAsset->GetKeyID(inAttackRangeKey);
+		keys->lineOfSight = blackboardAsset->GetKeyID(lineOfSightKey);
+	}
+
+	// unchanged values don't notify the observers (decorators...)
+	if (keys->playerDistance != FBlackboard::InvalidKey)
+	{
+		blackboard->SetValue<UBlackboardKeyType_Float>(keys->playerDistance, sense.distance);
+	}
+	if (keys->inPursueRange != FBlackboard::InvalidKey)
+	{
+		blackboard->SetValue<UBlackboardKeyType_Bool>(keys->inPursueRange, sense.bInPursueRange);
+	}
+	if (keys->inAttackRange != FBlackboard::InvalidKey)
+	{
+		blackboard->SetValue<UBlackboardKeyType_Bool>(keys->inAttackRange, sense.bInAttackRange);
+	}
+	if (keys->lineOfSight != FBlackboard::InvalidKey)
+	{
+		blackboard->SetValue<UBlackboardKeyType_Bool>(keys->lineOfSight, sense.bHasLineOfSight);
+	}
+}
@@ -0,0 +1,95 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "BehaviorTree/BlackboardComponent.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "EnemyPerceptionSubsystem.generated.h"
+
+class AEnemyBase;
+class UBlackboardData;
+
+/** What an enemy knows about the player, refreshed every frame by UEnemyPerceptionSubsystem */
+USTRUCT(BlueprintType)
+struct FEnemyPlayerSense
+{
+	GENERATED_BODY()
+
+	UPROPERTY(BlueprintReadOnly)
+	float distance = MAX_flt;
+
+	UPROPERTY(BlueprintReadOnly)
+	bool bInPursueRange = false;
+
+	UPROPERTY(BlueprintReadOnly)
+	bool bInAttackRange = false;
+
+	/** Only traced while in pursue range, a few enemies per frame */
+	UPROPERTY(BlueprintReadOnly)
+	bool bHasLineOfSight = false;
+};
+
+/**
+ * Senses the player for every live enemy in one pass per frame instead of a distance check or perception
+ * component per AI. Distances and range flags are computed over flat arrays, line of sight traces are
+ * spread over frames (maxTracesPerFrame, enemies in pursue range only). The results go on each enemy
+ * (AEnemyBase::GetPlayerSense) and into its blackboard under the configured key names.
+ */
+UCLASS(Config = Game)
+class RCT_API UEnemyPerceptionSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Deinitialize() override;
+
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+protected:
+	UPROPERTY(Config)
+	int32 maxTracesPerFrame = 8;
+
+	UPROPERTY(Config)
+	FName playerDistanceKey = TEXT("PlayerDistance");
+
+	UPROPERTY(Config)
+	FName inPursueRangeKey = TEXT("InPursueRange");
+
+	UPROPERTY(Config)
+	FName inAttackRangeKey = TEXT("InAttackRange");
+
+	UPROPERTY(Config)
+	FName lineOfSightKey = TEXT("HasLineOfSight");
+
+private:
+	struct FBlackboardKeys
+	{
+		FBlackboard::FKey playerDistance = FBlackboard::InvalidKey;
+		FBlackboard::FKey inPursueRange = FBlackboard::InvalidKey;
+		FBlackboard::FKey inAttackRange = FBlackboard::InvalidKey;
+		FBlackboard::FKey lineOfSight = FBlackboard::InvalidKey;
+	};
+
+	bool TraceLineOfSight(AEnemyBase* enemy, APawn* player) const;
+
+	void WriteBlackboard(AEnemyBase* enemy, const FEnemyPlayerSense& sense);
+
+	TArray<AEnemyBase*> enemies;
+
+	// Per enemy, in the order of enemies
+	TArray<float> positionsX;
+	TArray<float> positionsY;
+	TArray<float> positionsZ;
+	TArray<float> pursueRadiiSquared;
+	TArray<float> attackRangesSquared;
+	TArray<float> distancesSquared;
+
+	/** Enemies in pursue range this frame, the line of sight traces go round them */
+	TArray<int32> traceCandidates;
+	int32 traceCursor = 0;
+
+	/** Key ids per blackboard asset, looking them up by name walks every key */
+	TMap<const UBlackboardData*, FBlackboardKeys> blackboardKeys;
+};
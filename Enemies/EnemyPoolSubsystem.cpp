@@ -0,0 +1,134 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Enemies/EnemyPoolSubsystem.h"
+
+#include "Enemies/EnemyBase.h"
+#include "EngineUtils.h"
+
+void UEnemyPoolSubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+	Super::OnWorldBeginPlay(InWorld);
+
+	if (prewarmPerPlacedClass <= 0)
+	{
+		return;
+	}
+
+	TSet<UClass*> placedClasses;
+	for (TActorIterator<AEnemyBase> it(&InWorld); it; ++it)
+	{
+		placedClasses.Add(it->GetClass());
+	}
+
+	for (UClass* enemyClass : placedClasses)
+	{
+		Prewarm(enemyClass, prewarmPerPlacedClass);
+	}
+}
+
+void UEnemyPoolSubsystem::Deinitialize()
+{
+	pools.Empty();
+
+	Super::Deinitialize();
+}
+
+AEnemyBase* UEnemyPoolSubsystem::SpawnEnemy(TSubclassOf<AEnemyBase> enemyClass, const FTransform& transform)
+{
+	if (!enemyClass)
+	{
+		return nullptr;
+	}
+
+	AEnemyBase* enemy = nullptr;
+	if (FEnemyPool* pool = pools.Find(enemyClass))
+	{
+		while (enemy == nullptr && pool->enemies.Num() > 0)
+		{
+			enemy = pool->enemies.Pop(false);
+			if (!IsValid(enemy))
+			{
+				enemy = nullptr;
+			}
+		}
+	}
+
+	if (enemy == nullptr)
+	{
+		enemy = SpawnPooledEnemy(enemyClass);
+		if (enemy == nullptr)
+		{
+			return nullptr;
+		}
+	}
+
+	enemy->ActivateFromPool(transform);
+	enemy->OnActivatedFromPool();
+	return enemy;
+}
+
+bool UEnemyPoolSubsystem::ReleaseEnemy(AEnemyBase* enemy)
+{
+	if (!IsValid(enemy))
+	{
+		return false;
+	}
+	if (enemy->IsPooled())
+	{
+		return true;
+	}
+
+	FEnemyPool& pool = pools.FindOrAdd(enemy->GetClass());
+	if (pool.enemies.Num() >= maxPooledPerClass)
+	{
+		enemy->Destroy();
+		return false;
+	}
+
+	enemy->DeactivateForPool();
+	pool.enemies.Add(enemy);
+	return true;
+}
+
+void UEnemyPoolSubsystem::Prewarm(TSubclassOf<AEnemyBase> enemyClass, int32 count)
+{
+	if (!enemyClass)
+	{
+		return;
+	}
+
+	count = FMath::Min(count, maxPooledPerClass);
+	FEnemyPool& pool = pools.FindOrAdd(enemyClass);
+	while (pool.enemies.Num() < count)
+	{
+		AEnemyBase* enemy = SpawnPooledEnemy(enemyClass);
+		if (enemy == nullptr)
+		{
+			break;
+		}
+		pool.enemies.Add(enemy);
+	}
+}
+
+int32 UEnemyPoolSubsystem::GetPooledCount(TSubclassOf<AEnemyBase> enemyClass) const
+{
+	const FEnemyPool* pool = pools.Find(enemyClass);
+	return pool ? pool->enemies.Num() : 0;
+}
+
+AEnemyBase* UEnemyPoolSubsystem::SpawnPooledEnemy(TSubclassOf<AEnemyBase> enemyClass)
+{
+	// deferred so BeginPlay knows not to count the enemy in the room
+	const FTransform transform;
+	AEnemyBase* enemy = GetWorld()->SpawnActorDeferred<AEnemyBase>(enemyClass, transform, nullptr, nullptr,
+		ESpawnActorCollisionHandlingMethod::AlwaysSpawn);
+	if (enemy == nullptr)
+	{
+		return nullptr;
+	}
+
+	enemy->bStartPooled = true;
+	enemy->FinishSpawning(transform);
+	return enemy;
+}
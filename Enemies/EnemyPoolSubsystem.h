@@ -0,0 +1,61 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "EnemyPoolSubsystem.generated.h"
+
+class AEnemyBase;
+
+USTRUCT()
+struct FEnemyPool
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	TArray<AEnemyBase*> enemies;
+};
+
+/**
+ * Keeps dead enemies around deactivated (hidden, no collision, no tick, brain stopped) and hands them
+ * back out on spawn, so waves don't pay for character/AI controller creation and garbage collection.
+ */
+UCLASS(Config = Game)
+class RCT_API UEnemyPoolSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+	virtual void Deinitialize() override;
+
+	/** Takes an enemy of @enemyClass from the pool, or spawns one if the pool is empty */
+	UFUNCTION(BlueprintCallable)
+	AEnemyBase* SpawnEnemy(TSubclassOf<AEnemyBase> enemyClass, const FTransform& transform);
+
+	/** Deactivates @enemy and keeps it for the next spawn. Returns false if the pool of its class was full and it got destroyed instead */
+	UFUNCTION(BlueprintCallable)
+	bool ReleaseEnemy(AEnemyBase* enemy);
+
+	/** Spawns enemies straight into the pool until it holds @count of @enemyClass */
+	UFUNCTION(BlueprintCallable)
+	void Prewarm(TSubclassOf<AEnemyBase> enemyClass, int32 count);
+
+	UFUNCTION(BlueprintCallable, BlueprintPure)
+	int32 GetPooledCount(TSubclassOf<AEnemyBase> enemyClass) const;
+
+protected:
+	/** Pooled enemies prewarmed at level start for each enemy class placed in the level */
+	UPROPERTY(Config)
+	int32 prewarmPerPlacedClass = 4;
+
+	UPROPERTY(Config)
+	int32 maxPooledPerClass = 32;
+
+private:
+	AEnemyBase* SpawnPooledEnemy(TSubclassOf<AEnemyBase> enemyClass);
+
+	UPROPERTY()
+	TMap<UClass*, FEnemyPool> pools;
+};
@@ -0,0 +1,80 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Enemies/EnemySignificanceSubsystem.h"
+
+#include "Enemies/EnemyBase.h"
+#include "Kismet/GameplayStatics.h"
+#include "Systems/ActorRegistrySubsystem.h"
+
+void UEnemySignificanceSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	timeUntilUpdate -= DeltaTime;
+	if (timeUntilUpdate > 0.f)
+	{
+		return;
+	}
+	timeUntilUpdate = updateInterval;
+
+	UpdateSignificance();
+}
+
+void UEnemySignificanceSubsystem::UpdateSignificance()
+{
+	UActorRegistrySubsystem* registry = GetWorld()->GetSubsystem<UActorRegistrySubsystem>();
+	APawn* player = UGameplayStatics::GetPlayerPawn(GetWorld(), 0);
+	if (registry == nullptr || player == nullptr)
+	{
+		return;
+	}
+
+	registry->GetLiveEnemies(enemies);
+
+	const FVector playerLocation = player->GetActorLocation();
+	const float nearDistanceSquared = nearDistance * nearDistance;
+	const float farDistanceSquared = farDistance * farDistance;
+
+	for (AEnemyBase* enemy : enemies)
+	{
+		if (enemy->IsPooled())
+		{
+			continue;
+		}
+
+		const float distanceSquared = FVector::DistSquared(playerLocation, enemy->GetActorLocation());
+
+		EEnemySignificance significance = EEnemySignificance::Low;
+		if (distanceSquared <= nearDistanceSquared || enemy->NeedsFullTickRate())
+		{
+			significance = EEnemySignificance::High;
+		}
+		else if (distanceSquared <= farDistanceSquared && enemy->WasRecentlyRendered(visibilityTolerance))
+		{
+			significance = EEnemySignificance::Medium;
+		}
+
+		enemy->ApplySignificance(significance, GetTickInterval(significance));
+	}
+
+	enemies.Reset();
+}
+
+float UEnemySignificanceSubsystem::GetTickInterval(EEnemySignificance significance) const
+{
+	switch (significance)
+	{
+	case EEnemySignificance::Medium:
+		return mediumTickInterval;
+	case EEnemySignificance::Low:
+		return lowTickInterval;
+	default:
+		return 0.f;
+	}
+}
+
+TStatId UEnemySignificanceSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UEnemySignificanceSubsystem, STATGROUP_Tickables);
+}
@@ -0,0 +1,62 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "EnemySignificanceSubsystem.generated.h"
+
+UENUM(BlueprintType)
+enum class EEnemySignificance : uint8
+{
+	High,
+	Medium,
+	Low,
+};
+
+/**
+ * Ranks the live enemies a few times per second by distance to the player and whether they were rendered,
+ * and scales the tick interval of their actor, movement, mesh (animation) and AI brain to match.
+ */
+UCLASS(Config = Game)
+class RCT_API UEnemySignificanceSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	UFUNCTION(BlueprintCallable, BlueprintPure)
+	float GetTickInterval(EEnemySignificance significance) const;
+
+protected:
+	/** Seconds between two ranking passes */
+	UPROPERTY(Config)
+	float updateInterval = 0.25f;
+
+	/** Enemies closer than this always tick every frame, seen or not */
+	UPROPERTY(Config)
+	float nearDistance = 1500.f;
+
+	/** Visible enemies up to this distance are medium, everything else is low */
+	UPROPERTY(Config)
+	float farDistance = 4000.f;
+
+	UPROPERTY(Config)
+	float mediumTickInterval = 0.1f;
+
+	UPROPERTY(Config)
+	float lowTickInterval = 0.4f;
+
+	/** How recently an enemy must have been rendered to count as on screen */
+	UPROPERTY(Config)
+	float visibilityTolerance = 0.2f;
+
+private:
+	void UpdateSignificance();
+
+	float timeUntilUpdate = 0.f;
+
+	TArray<class AEnemyBase*> enemies;
+};
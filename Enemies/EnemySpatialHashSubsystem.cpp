@@ -0,0 +1,111 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Enemies/EnemySpatialHashSubsystem.h"
+
+#include "Enemies/EnemyMovementComponent.h"
+
+void UEnemySpatialHashSubsystem::Deinitialize()
+{
+	agents.Empty();
+	entries.Empty();
+	cells.Empty();
+
+	Super::Deinitialize();
+}
+
+void UEnemySpatialHashSubsystem::AddAgent(UEnemyMovementComponent* agent)
+{
+	if (agent)
+	{
+		agents.AddUnique(agent);
+	}
+}
+
+void UEnemySpatialHashSubsystem::RemoveAgent(UEnemyMovementComponent* agent)
+{
+	agents.RemoveSwap(agent);
+}
+
+FVector UEnemySpatialHashSubsystem::GetSeparation(const UEnemyMovementComponent* agent, const FVector& location, float radius) const
+{
+	FVector separation = FVector::ZeroVector;
+
+	const FIntPoint center = ToCell(location);
+	for (int32 y = -1; y <= 1; y++)
+	{
+		for (int32 x = -1; x <= 1; x++)
+		{
+			const TArray<int32, TInlineAllocator<8>>* cell = cells.Find(center + FIntPoint(x, y));
+			if (cell == nullptr)
+			{
+				continue;
+			}
+
+			for (int32 index : *cell)
+			{
+				const FAgentEntry& other = entries[index];
+				if (other.agent == agent)
+				{
+					continue;
+				}
+
+				FVector away = location - other.location;
+				away.Z = 0.f;
+				const float minDistance = radius + other.radius;
+				const float distanceSquared = away.SizeSquared();
+				if (distanceSquared >= minDistance * minDistance || distanceSquared < KINDA_SMALL_NUMBER)
+				{
+					continue;
+				}
+
+				const float distance = FMath::Sqrt(distanceSquared);
+				separation += away / distance * (1.f - distance / minDistance);
+			}
+		}
+	}
+	return separation;
+}
+
+void UEnemySpatialHashSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	entries.Reset();
+	cells.Reset();
+
+	for (int32 i = agents.Num() - 1; i >= 0; i--)
+	{
+		UEnemyMovementComponent* agent = agents[i].Get();
+		if (agent == nullptr)
+		{
+			agents.RemoveAtSwap(i);
+			continue;
+		}
+
+		// pooled enemies stop ticking their movement, they are nobody's neighbour
+		if (!agent->IsComponentTickEnabled() || agent->UpdatedComponent == nullptr)
+		{
+			continue;
+		}
+
+		const FVector location = agent->UpdatedComponent->GetComponentLocation();
+		const int32 index = entries.Add({ agent, location, agent->GetSeparationRadius() });
+		cells.FindOrAdd(ToCell(location)).Add(index);
+	}
+}
+
+bool UEnemySpatialHashSubsystem::IsTickable() const
+{
+	return agents.Num() > 0;
+}
+
+TStatId UEnemySpatialHashSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UEnemySpatialHashSubsystem, STATGROUP_Tickables);
+}
+
+FIntPoint UEnemySpatialHashSubsystem::ToCell(const FVector& location) const
+{
+	return FIntPoint(FMath::FloorToInt(location.X / cellSize), FMath::FloorToInt(location.Y / cellSize));
+}
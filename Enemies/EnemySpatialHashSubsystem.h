@@ -0,0 +1,54 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "EnemySpatialHashSubsystem.generated.h"
+
+class UEnemyMovementComponent;
+
+/**
+ * Grid of the enemies using simple movement, rebuilt once per frame, so each one finds the neighbours it
+ * has to keep its distance from without an overlap query. Queries read the positions of the last rebuild.
+ */
+UCLASS(Config = Game)
+class RCT_API UEnemySpatialHashSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Deinitialize() override;
+
+	void AddAgent(UEnemyMovementComponent* agent);
+
+	void RemoveAgent(UEnemyMovementComponent* agent);
+
+	/** Sum of the pushes away from every agent overlapping @agent, each one up to length 1 for a full overlap */
+	FVector GetSeparation(const UEnemyMovementComponent* agent, const FVector& location, float radius) const;
+
+	virtual void Tick(float DeltaTime) override;
+	virtual bool IsTickable() const override;
+	virtual TStatId GetStatId() const override;
+
+protected:
+	/** Has to be at least twice the biggest separation radius, queries only look at the neighbouring cells */
+	UPROPERTY(Config)
+	float cellSize = 200.f;
+
+private:
+	struct FAgentEntry
+	{
+		const UEnemyMovementComponent* agent;
+		FVector location;
+		float radius;
+	};
+
+	FIntPoint ToCell(const FVector& location) const;
+
+	TArray<TWeakObjectPtr<UEnemyMovementComponent>> agents;
+
+	TArray<FAgentEntry> entries;
+
+	TMap<FIntPoint, TArray<int32, TInlineAllocator<8>>> cells;
+};
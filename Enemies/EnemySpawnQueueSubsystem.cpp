@@ -0,0 +1,168 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Enemies/EnemySpawnQueueSubsystem.h"
+
+#include "Camera/PlayerCameraManager.h"
+#include "Enemies/EnemyBase.h"
+#include "Enemies/EnemyCrowdSubsystem.h"
+#include "Enemies/EnemyPoolSubsystem.h"
+#include "Kismet/GameplayStatics.h"
+#include "Systems/ActorRegistrySubsystem.h"
+
+DECLARE_STATS_GROUP(TEXT("EnemySpawnQueue"), STATGROUP_EnemySpawnQueue, STATCAT_Advanced);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Queued Spawns"), STAT_QueuedSpawns, STATGROUP_EnemySpawnQueue);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Spawns This Frame"), STAT_SpawnsThisFrame, STATGROUP_EnemySpawnQueue);
+DECLARE_FLOAT_COUNTER_STAT(TEXT("Spawn Time (ms)"), STAT_SpawnTimeMs, STATGROUP_EnemySpawnQueue);
+
+// a priority level outweighs any distance
+static constexpr float SpawnPriorityWeight = 1000000.f;
+
+void UEnemySpawnQueueSubsystem::Deinitialize()
+{
+	queue.Empty();
+
+	Super::Deinitialize();
+}
+
+void UEnemySpawnQueueSubsystem::QueueSpawn(TSubclassOf<AEnemyBase> enemyClass, const FTransform& transform, int32 priority)
+{
+	if (!enemyClass)
+	{
+		return;
+	}
+
+	FQueuedSpawn& queued = queue.AddDefaulted_GetRef();
+	queued.request.enemyClass = enemyClass;
+	queued.request.transform = transform;
+	queued.request.priority = priority;
+
+	if (UActorRegistrySubsystem* registry = GetWorld()->GetSubsystem<UActorRegistrySubsystem>())
+	{
+		registry->AddQueuedEnemy();
+	}
+}
+
+void UEnemySpawnQueueSubsystem::QueueWave(const TArray<FEnemySpawnRequest>& wave)
+{
+	queue.Reserve(queue.Num() + wave.Num());
+	for (const FEnemySpawnRequest& request : wave)
+	{
+		QueueSpawn(request.enemyClass, request.transform, request.priority);
+	}
+}
+
+void UEnemySpawnQueueSubsystem::ClearQueue()
+{
+	if (UActorRegistrySubsystem* registry = GetWorld()->GetSubsystem<UActorRegistrySubsystem>())
+	{
+		for (int32 i = 0; i < queue.Num(); i++)
+		{
+			registry->RemoveQueuedEnemy();
+		}
+	}
+	queue.Reset();
+}
+
+void UEnemySpawnQueueSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	const double startTime = FPlatformTime::Seconds();
+
+	ScoreQueue();
+	// best last, spawns pop off the end
+	queue.Sort([](const FQueuedSpawn& a, const FQueuedSpawn& b)
+	{
+		return a.score < b.score;
+	});
+
+	APawn* player = UGameplayStatics::GetPlayerPawn(GetWorld(), 0);
+	const FVector playerLocation = player ? player->GetActorLocation() : FVector::ZeroVector;
+	UActorRegistrySubsystem* registry = GetWorld()->GetSubsystem<UActorRegistrySubsystem>();
+
+	int32 spawnCount = 0;
+	const double budgetSeconds = spawnBudgetMs * 0.001;
+	while (queue.Num() > 0 && (spawnCount == 0 || FPlatformTime::Seconds() - startTime < budgetSeconds))
+	{
+		const FEnemySpawnRequest request = queue.Pop(false).request;
+		SpawnQueued(request, playerLocation, player != nullptr);
+		spawnCount++;
+
+		// counted again by RegisterEnemy or the crowd, or the spawn failed
+		if (registry)
+		{
+			registry->RemoveQueuedEnemy();
+		}
+	}
+
+	lastSpawnTimeMs = (FPlatformTime::Seconds() - startTime) * 1000.0;
+
+	SET_DWORD_STAT(STAT_QueuedSpawns, queue.Num());
+	SET_DWORD_STAT(STAT_SpawnsThisFrame, spawnCount);
+	SET_FLOAT_STAT(STAT_SpawnTimeMs, lastSpawnTimeMs);
+}
+
+bool UEnemySpawnQueueSubsystem::IsTickable() const
+{
+	return queue.Num() > 0;
+}
+
+TStatId UEnemySpawnQueueSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UEnemySpawnQueueSubsystem, STATGROUP_Tickables);
+}
+
+void UEnemySpawnQueueSubsystem::ScoreQueue()
+{
+	APlayerCameraManager* cameraManager = UGameplayStatics::GetPlayerCameraManager(GetWorld(), 0);
+	APawn* player = UGameplayStatics::GetPlayerPawn(GetWorld(), 0);
+	if (cameraManager == nullptr && player == nullptr)
+	{
+		for (FQueuedSpawn& queued : queue)
+		{
+			queued.score = queued.request.priority * SpawnPriorityWeight;
+		}
+		return;
+	}
+
+	const FVector referenceLocation = player ? player->GetActorLocation() : cameraManager->GetCameraLocation();
+	const FVector cameraLocation = cameraManager ? cameraManager->GetCameraLocation() : referenceLocation;
+	const FVector cameraForward = cameraManager ? cameraManager->GetCameraRotation().Vector() : FVector::ZeroVector;
+	const float cosHalfFov = cameraManager ? FMath::Cos(FMath::DegreesToRadians(cameraManager->GetFOVAngle() * 0.5f)) : 2.f;
+
+	for (FQueuedSpawn& queued : queue)
+	{
+		const FVector location = queued.request.transform.GetLocation();
+		float score = queued.request.priority * SpawnPriorityWeight - FVector::Dist(location, referenceLocation);
+
+		// a cone check is enough, the queue only needs an order
+		const FVector toSpawn = (location - cameraLocation).GetSafeNormal();
+		if (FVector::DotProduct(toSpawn, cameraForward) >= cosHalfFov)
+		{
+			score += onScreenBonus;
+		}
+		queued.score = score;
+	}
+}
+
+bool UEnemySpawnQueueSubsystem::SpawnQueued(const FEnemySpawnRequest& request, const FVector& playerLocation, bool bHasPlayer)
+{
+	if (bHasPlayer && FVector::DistSquared(request.transform.GetLocation(), playerLocation) > FMath::Square(crowdSpawnDistance))
+	{
+		UEnemyCrowdSubsystem* crowd = GetWorld()->GetSubsystem<UEnemyCrowdSubsystem>();
+		if (crowd && crowd->AddCrowdEnemy(request.enemyClass, request.transform))
+		{
+			return true;
+		}
+	}
+
+	if (UEnemyPoolSubsystem* pool = GetWorld()->GetSubsystem<UEnemyPoolSubsystem>())
+	{
+		return pool->SpawnEnemy(request.enemyClass, request.transform) != nullptr;
+	}
+
+	FActorSpawnParameters spawnParams;
+	spawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AdjustIfPossibleButAlwaysSpawn;
+	return GetWorld()->SpawnActor<AEnemyBase>(request.enemyClass, request.transform, spawnParams) != nullptr;
+}
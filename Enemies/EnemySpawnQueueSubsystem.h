@@ -0,0 +1,95 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "EnemySpawnQueueSubsystem.generated.h"
+
+class AEnemyBase;
+
+USTRUCT(BlueprintType)
+struct FEnemySpawnRequest
+{
+	GENERATED_BODY()
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	TSubclassOf<AEnemyBase> enemyClass;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	FTransform transform;
+
+	/** Higher goes first, distance to the player and being on screen only order spawns of the same priority */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	int32 priority = 0;
+};
+
+/**
+ * Spreads the spawns of a wave over frames, spending at most spawnBudgetMs per frame on them (at least one
+ * spawn per frame so the queue always drains). Spawns near the player or on screen go first, far ones go
+ * straight into UEnemyCrowdSubsystem when their class has a crowd mesh. Queued enemies already count towards
+ * the room. Queue depth and spawn cost show up under "stat EnemySpawnQueue".
+ */
+UCLASS(Config = Game)
+class RCT_API UEnemySpawnQueueSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Deinitialize() override;
+
+	UFUNCTION(BlueprintCallable)
+	void QueueSpawn(TSubclassOf<AEnemyBase> enemyClass, const FTransform& transform, int32 priority = 0);
+
+	UFUNCTION(BlueprintCallable)
+	void QueueWave(const TArray<FEnemySpawnRequest>& wave);
+
+	/** Drops every spawn still waiting */
+	UFUNCTION(BlueprintCallable)
+	void ClearQueue();
+
+	UFUNCTION(BlueprintCallable, BlueprintPure)
+	int32 GetQueuedCount() const
+	{
+		return queue.Num();
+	}
+
+	/** Milliseconds spent spawning on the last frame that had something queued */
+	UFUNCTION(BlueprintCallable, BlueprintPure)
+	float GetLastSpawnTimeMs() const
+	{
+		return lastSpawnTimeMs;
+	}
+
+	virtual void Tick(float DeltaTime) override;
+	virtual bool IsTickable() const override;
+	virtual TStatId GetStatId() const override;
+
+protected:
+	UPROPERTY(Config)
+	float spawnBudgetMs = 2.f;
+
+	/** Spawns further than this from the player go into the crowd, keep it at UEnemyCrowdSubsystem's promoteDistance */
+	UPROPERTY(Config)
+	float crowdSpawnDistance = 3000.f;
+
+	/** Score bonus of a spawn inside the camera's view, in units of distance */
+	UPROPERTY(Config)
+	float onScreenBonus = 2000.f;
+
+private:
+	struct FQueuedSpawn
+	{
+		FEnemySpawnRequest request;
+		/** Priority first, then closest / on screen, refreshed every frame */
+		float score = 0.f;
+	};
+
+	void ScoreQueue();
+
+	bool SpawnQueued(const FEnemySpawnRequest& request, const FVector& playerLocation, bool bHasPlayer);
+
+	TArray<FQueuedSpawn> queue;
+
+	float lastSpawnTimeMs = 0.f;
+};
@@ -0,0 +1,100 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Enemies/EnemyStatCache.h"
+
+#include "Engine/DataTable.h"
+
+void UEnemyStatCache::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	statsTable = statsTablePath.LoadSynchronous();
+	if (statsTable == nullptr)
+	{
+		UE_LOG(LogTemp, Error, TEXT("Unable to load the enemy stats table %s"), *statsTablePath.ToString());
+		return;
+	}
+
+#if WITH_EDITOR
+	tableChangedHandle = statsTable->OnDataTableChanged().AddUObject(this, &UEnemyStatCache::ReloadRows);
+#endif
+}
+
+void UEnemyStatCache::Deinitialize()
+{
+#if WITH_EDITOR
+	if (statsTable)
+	{
+		statsTable->OnDataTableChanged().Remove(tableChangedHandle);
+	}
+#endif
+
+	Super::Deinitialize();
+}
+
+int32 UEnemyStatCache::ResolveTypeId(UClass* enemyClass, FName enemyName)
+{
+	if (const int32* typeId = typeIdsByClass.Find(enemyClass))
+	{
+		return *typeId;
+	}
+
+	int32 typeId = INDEX_NONE;
+	if (const int32* existingId = typeIdsByName.Find(enemyName))
+	{
+		typeId = *existingId;
+	}
+	else if (statsTable)
+	{
+		const FEnemyStatData* row = statsTable->FindRow<FEnemyStatData>(enemyName, TEXT("Enemy Stats Init"));
+		if (row)
+		{
+			typeId = rows.Add(*row);
+			rowValid.Add(true);
+			typeIdsByName.Add(enemyName, typeId);
+		}
+	}
+
+	if (typeId == INDEX_NONE)
+	{
+		// misses are cached too, so this only shows up once per class
+		UE_LOG(LogTemp, Warning, TEXT("Unable to find enemy stats row %s for %s"), *enemyName.ToString(), *GetNameSafe(enemyClass));
+	}
+
+	typeIdsByClass.Add(enemyClass, typeId);
+	return typeId;
+}
+
+const FEnemyStatData* UEnemyStatCache::GetStats(int32 typeId) const
+{
+	if (!rows.IsValidIndex(typeId) || !rowValid[typeId])
+	{
+		return nullptr;
+	}
+	return &rows[typeId];
+}
+
+void UEnemyStatCache::ReloadRows()
+{
+	for (const TPair<FName, int32>& entry : typeIdsByName)
+	{
+		const FEnemyStatData* row = statsTable->FindRow<FEnemyStatData>(entry.Key, TEXT("Enemy Stats Reload"), false);
+		rowValid[entry.Value] = row != nullptr;
+		if (row)
+		{
+			rows[entry.Value] = *row;
+		}
+	}
+
+	// classes that had no row get another chance
+	for (auto it = typeIdsByClass.CreateIterator(); it; ++it)
+	{
+		if (it.Value() == INDEX_NONE)
+		{
+			it.RemoveCurrent();
+		}
+	}
+
+	onStatsReloaded.Broadcast();
+}
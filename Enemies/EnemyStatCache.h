@@ -0,0 +1,57 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "Enemies/EnemyStatData.h"
+
+#include "CoreMinimal.h"
+#include "Subsystems/GameInstanceSubsystem.h"
+#include "EnemyStatCache.generated.h"
+
+/**
+ * Resolves the enemy data table rows once per enemy type into a flat array indexed by type ID,
+ * so spawning an enemy is an array lookup instead of a FindRow.
+ * The table is a soft reference now: /Game/DataFiles has to stay in the cooked directories.
+ */
+UCLASS(Config = Game)
+class RCT_API UEnemyStatCache : public UGameInstanceSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+
+	/** Type ID for @enemyClass, resolving @enemyName in the table the first time the class is seen. INDEX_NONE if there's no row */
+	int32 ResolveTypeId(UClass* enemyClass, FName enemyName);
+
+	/** nullptr for INDEX_NONE or a row that got removed from the table */
+	const FEnemyStatData* GetStats(int32 typeId) const;
+
+	UDataTable* GetTable() const
+	{
+		return statsTable;
+	}
+
+	/** Fired after the rows got re-resolved because the table was edited */
+	FSimpleMulticastDelegate onStatsReloaded;
+
+protected:
+	UPROPERTY(Config)
+	TSoftObjectPtr<UDataTable> statsTablePath = TSoftObjectPtr<UDataTable>(FSoftObjectPath(TEXT("/Game/DataFiles/EnemyDataTable.EnemyDataTable")));
+
+	UPROPERTY()
+	UDataTable* statsTable;
+
+private:
+	void ReloadRows();
+
+	// Indexed by type ID, IDs never change while the game runs so live enemies stay valid across reloads
+	TArray<FEnemyStatData> rows;
+	TArray<bool> rowValid;
+	TMap<FName, int32> typeIdsByName;
+
+	TMap<TWeakObjectPtr<UClass>, int32> typeIdsByClass;
+
+	FDelegateHandle tableChangedHandle;
+};
@@ -7,16 +7,20 @@
 #include "BrainComponent.h"
 #include "PlayerCharacter/RCTCharacter.h"
 #include "Kismet/GameplayStatics.h"
-#include "NiagaraFunctionLibrary.h"
+#include "Systems/CombatFeedbackSubsystem.h"
+#include "Systems/DamageOverTimeSubsystem.h"
+#include "Systems/ExplosionSubsystem.h"
+#include "Enemies/ThrownEnemySubsystem.h"
 #include "Components/CapsuleComponent.h"
+#include "Components/StaticMeshComponent.h"
+#include "GameFramework/CharacterMovementComponent.h"
 
-AGrabableEnemy::AGrabableEnemy()
+AGrabableEnemy::AGrabableEnemy(const FObjectInitializer& ObjectInitializer)
+	: Super(ObjectInitializer)
 {
  	// Need to keep the tick for the collision fix
 	PrimaryActorTick.bCanEverTick = true;
 
-	UCapsuleComponent* capsule = FindComponentByClass<UCapsuleComponent>();
-
 	stopSlidingVelocityThreshold = 10.0f;
 	
 	originalCollisionProfileName = GetCapsuleComponent()->GetCollisionProfileName();
@@ -26,53 +30,119 @@ AGrabableEnemy::AGrabableEnemy()
 void AGrabableEnemy::BeginPlay()
 {
 	Super::BeginPlay();
+
+	CachePhysicsComponents();
+	// sizes the mesh's custom data once, highlighting only writes the value afterwards
+	GetMesh()->SetCustomPrimitiveDataFloat(highlightPrimitiveDataIndex, 0.f);
+	cachedPlayer = Cast<ARCTCharacter>(UGameplayStatics::GetPlayerCharacter(GetWorld(), 0));
 }
 
-float AGrabableEnemy::TakeDamage(float damageAmount, FDamageEvent const& damageEvent, AController* eventInstigator, AActor* damageCauser)
+void AGrabableEnemy::CachePhysicsComponents()
 {
-	if (damageEvent.IsOfType(FRadialDamageEvent::ClassID))
+	impulseComponents.Reset();
+	GetComponents<UStaticMeshComponent>(impulseComponents);
+	cachedComponentCount = GetComponents().Num();
+	bPhysicsComponentsDirty = false;
+}
+
+void AGrabableEnemy::ApplyExplosionImpulse(const FVector& origin, float radius, float strength)
+{
+	// a count change catches plain adds and removes, a cached mesh gone or moved to another actor catches a swap
+	// within the same frame, and InvalidatePhysicsComponents covers whatever adds meshes without removing ours
+	bool bStale = bPhysicsComponentsDirty || cachedComponentCount != GetComponents().Num();
+	for (int32 i = 0; i < impulseComponents.Num() && !bStale; i++)
 	{
-		auto player = Cast<ARCTCharacter>(UGameplayStatics::GetPlayerCharacter(GetWorld(), 0));
-		if (player == nullptr)
-		{
-			UE_LOG(LogTemp, Error, TEXT("Unable to find player in AGrabableEnemy::TakeDamage"));
-			return 0;
-		}
-		TArray<UStaticMeshComponent*> staticMeshComponents;
-		GetComponents<UStaticMeshComponent>(staticMeshComponents);
-		for (auto& mesh : staticMeshComponents)
+		const UStaticMeshComponent* mesh = impulseComponents[i];
+		bStale = !IsValid(mesh) || mesh->GetOwner() != this || !mesh->IsRegistered();
+	}
+	if (bStale)
+	{
+		CachePhysicsComponents();
+	}
+
+	for (UStaticMeshComponent* mesh : impulseComponents)
+	{
+		if (IsValid(mesh))
 		{
-			mesh->AddRadialImpulse(damageCauser->GetActorLocation(), player->GetThrowExplosionRadius(), player->GetThrowKnockbackImpulse(), ERadialImpulseFalloff::RIF_Constant);
+			mesh->AddRadialImpulse(origin, radius, strength, ERadialImpulseFalloff::RIF_Constant);
 		}
 	}
-	return Super::TakeDamage(damageAmount, damageEvent, eventInstigator, damageCauser);
 }
 
+ARCTCharacter* AGrabableEnemy::GetCachedPlayer()
+{
+	// the player may not be possessed yet when a placed enemy begins play
+	if (!cachedPlayer.IsValid())
+	{
+		cachedPlayer = Cast<ARCTCharacter>(UGameplayStatics::GetPlayerCharacter(GetWorld(), 0));
+	}
+	return cachedPlayer.Get();
+}
+
+float AGrabableEnemy::TakeDamage(float damageAmount, FDamageEvent const& damageEvent, AController* eventInstigator, AActor* damageCauser)
+{
+	// knockback from explosions is applied by UExplosionSubsystem through ApplyExplosionImpulse
+	const float damageTaken = Super::TakeDamage(damageAmount, damageEvent, eventInstigator, damageCauser);
+
+	// killed by its own blast, goes away with it instead of ragdolling
+	if (damageCauser == this && bExploded && health <= 0)
+	{
+		Despawn();
+	}
+	return damageTaken;
+}
+
+
+void AGrabableEnemy::DeactivateForPool()
+{
+	// the character would keep holding us while the pool hands us out to someone else
+	if (grabbingCharacter != nullptr)
+	{
+		grabbingCharacter->LetGo();
+	}
+
+	Super::DeactivateForPool();
+
+	grabbingCharacter = nullptr;
+	bExploded = false;
+	bKinematicFlight = false;
+	SetHilighting_Implementation(false);
+
+	if (UThrownEnemySubsystem* thrownEnemies = GetWorld()->GetSubsystem<UThrownEnemySubsystem>())
+	{
+		thrownEnemies->RemoveThrownEnemy(this);
+	}
+
+	UCapsuleComponent* capsule = GetCapsuleComponent();
+	capsule->OnComponentHit.RemoveAll(this);
+	capsule->SetSimulatePhysics(false);
+}
+
+bool AGrabableEnemy::NeedsActorTick() const
+{
+	return (grabbingCharacter != nullptr && bKinematicThrow) || Super::NeedsActorTick();
+}
+
+bool AGrabableEnemy::NeedsFullTickRate() const
+{
+	return grabbingCharacter != nullptr || bKinematicFlight;
+}
+
+bool AGrabableEnemy::IsAirborne() const
+{
+	return bKinematicFlight && GetCharacterMovement()->IsFalling();
+}
 
 // Called every frame
 void AGrabableEnemy::Tick(float DeltaTime)
 {
-
 	Super::Tick(DeltaTime);
 
-	if (grabbingCharacter != nullptr)
+	// the hand carries us while held, its speed is the launch speed of a kinematic throw
+	if (grabbingCharacter != nullptr && DeltaTime > 0.f)
 	{
-		if(health > 0)
-		{
-			// Subtract Health
-			float modifier = 0.f;
-			if (PrimaryActorTick.TickGroup == 0)
-			{
-				modifier -= grabbingCharacter->GetDevourDamage() * DeltaTime;
-			}
-			else
-			{
-				modifier -= grabbingCharacter->GetDevourDamage();
-			}
-			grabbingCharacter->AbsorbAfterDamaging(-modifier);
-			UGameplayStatics::ApplyDamage(this, 0, GetController(), this, UDamageType::StaticClass());
-			ModifyHealth(modifier);
-		}
+		heldVelocity = (GetActorLocation() - lastHeldLocation) / DeltaTime;
+		lastHeldLocation = GetActorLocation();
 	}
 }
 
@@ -99,8 +169,29 @@ void AGrabableEnemy::Grab_Implementation(ARCTCharacter* character)
 		}
 		*/
 
+		// caught again before landing, no more sliding and the fuse of the last throw is out
+		if (UThrownEnemySubsystem* thrownEnemies = GetWorld()->GetSubsystem<UThrownEnemySubsystem>())
+		{
+			thrownEnemies->RemoveThrownEnemy(this);
+		}
+		if (bKinematicFlight)
+		{
+			EndKinematicFlight();
+			GetCharacterMovement()->StopMovementImmediately();
+		}
+		heldVelocity = FVector::ZeroVector;
+		lastHeldLocation = GetActorLocation();
+
+		// don't wait for the next significance pass, we move with the hand from now on
+		ApplySignificance(EEnemySignificance::High, 0.f);
+
+		// drained every frame while held, the health goes to the grabbing character
+		if (UDamageOverTimeSubsystem* damageOverTime = GetWorld()->GetSubsystem<UDamageOverTimeSubsystem>())
+		{
+			damageOverTime->AddEffect(this, character, EDamageOverTimeKind::Devour, character->GetDevourDamage(), 0.f, true);
+		}
+
 		character->AttachToArm(this);
-		hpZeroEvent.AddUniqueDynamic(character, &ARCTCharacter::PromptForDevour);
 
 		// Stop BT
 		AAIController* controller = Cast<AAIController>(GetController());
@@ -123,9 +214,13 @@ void AGrabableEnemy::LetGo_Implementation(ARCTCharacter* character)
 	if (grabbingCharacter != nullptr && grabbingCharacter == character)
 	{
 		grabbingCharacter = nullptr;
+		if (UDamageOverTimeSubsystem* damageOverTime = GetWorld()->GetSubsystem<UDamageOverTimeSubsystem>())
+		{
+			damageOverTime->RemoveEffect(this, EDamageOverTimeKind::Devour);
+		}
+
 		FDetachmentTransformRules rules(EDetachmentRule::KeepWorld, EDetachmentRule::KeepWorld, EDetachmentRule::KeepWorld, true);
 		DetachFromActor(rules);
-		deathEvent.RemoveAll(grabbingCharacter);
 		character->EndPromptForDevour();
 		
 		// Enable collision if it was disabled
@@ -133,29 +228,34 @@ void AGrabableEnemy::LetGo_Implementation(ARCTCharacter* character)
 			GetCapsuleComponent()->SetCollisionProfileName(originalCollisionProfileName);
 		}
 
-		FTimerHandle handle;
 		bExploded = false;
 
-		AAIController* controller = Cast<AAIController>(GetController());
-		if(controller)
-		{
-			controller->GetBrainComponent()->ResumeLogic("LetGo");
-		}
-		
 		// Throwing
 		GetCapsuleComponent()->OnComponentHit.AddUniqueDynamic(this, &AGrabableEnemy::OverlapExplode);
-		GetCapsuleComponent()->SetSimulatePhysics(true);
-
-		GetWorldTimerManager().SetTimer(thrownSlideHandle, this, &AGrabableEnemy::ThrownSlide, 0.1f, true);
-
-		auto player = Cast<ARCTCharacter>(UGameplayStatics::GetPlayerCharacter(GetWorld(), 0));
-		if (player != nullptr)
+		if (bKinematicThrow)
 		{
-			GetWorldTimerManager().SetTimer(handle, this, &AGrabableEnemy::Explode, player->GetThrowTimeToExplode(), false);
+			// the brain stays paused until we land, see EndKinematicFlight
+			bKinematicFlight = true;
+			GetCapsuleComponent()->OnComponentHit.AddUniqueDynamic(this, &AGrabableEnemy::OnKinematicThrowHit);
+			LaunchCharacter(heldVelocity, true, true);
 		}
 		else
 		{
-			GetWorldTimerManager().SetTimer(handle, this, &AGrabableEnemy::Explode, throwTimeToExplode, false);
+			AAIController* controller = Cast<AAIController>(GetController());
+			if(controller)
+			{
+				controller->GetBrainComponent()->ResumeLogic("LetGo");
+			}
+			GetCapsuleComponent()->SetSimulatePhysics(true);
+		}
+
+		// the held velocity tick isn't needed anymore, the next significance pass would take a while
+		ApplySignificance(significance, 0.f);
+
+		ARCTCharacter* player = GetCachedPlayer();
+		if (UThrownEnemySubsystem* thrownEnemies = GetWorld()->GetSubsystem<UThrownEnemySubsystem>())
+		{
+			thrownEnemies->AddThrownEnemy(this, player != nullptr ? player->GetThrowTimeToExplode() : throwTimeToExplode);
 		}
 		// AddOverlapBegin
 		
@@ -171,7 +271,10 @@ void AGrabableEnemy::HitByFist()
 	}
 
 	GetCapsuleComponent()->SetSimulatePhysics(true);
-	GetWorldTimerManager().SetTimer(thrownSlideHandle, this, &AGrabableEnemy::ThrownSlide, 0.1f, true);
+	if (UThrownEnemySubsystem* thrownEnemies = GetWorld()->GetSubsystem<UThrownEnemySubsystem>())
+	{
+		thrownEnemies->AddThrownEnemy(this, 0.f);
+	}
 }
 
 bool AGrabableEnemy::CanBeGrabbed_Implementation()
@@ -187,16 +290,61 @@ bool AGrabableEnemy::IsGrabbed_Implementation()
 
 void AGrabableEnemy::SetHilighting_Implementation(bool bIfHighlight)
 {
-	GetMesh()->SetScalarParameterValueOnMaterials("GrabToggle", bIfHighlight);
+	if (bHighlighted == bIfHighlight)
+	{
+		return;
+	}
+	bHighlighted = bIfHighlight;
+
+	// per primitive data instead of dynamic material instances, the crowd keeps sharing its materials
+	GetMesh()->SetCustomPrimitiveDataFloat(highlightPrimitiveDataIndex, bIfHighlight ? 1.f : 0.f);
+}
+
+void AGrabableEnemy::StopSliding()
+{
+	EndKinematicFlight();
+	GetCapsuleComponent()->SetSimulatePhysics(false);
+}
+
+void AGrabableEnemy::OnKinematicThrowHit(UPrimitiveComponent* HitComponent, AActor* OtherActor,
+                                         UPrimitiveComponent* OtherComp, FVector NormalImpulse, const FHitResult& Hit)
+{
+	if (!bKinematicFlight || IsPooled())
+	{
+		return;
+	}
+
+	// landing and sliding on walkable ground stays on the movement component, bouncing off walls
+	// and pushing simulated bodies around needs the real thing
+	UCharacterMovementComponent* moveComponent = GetCharacterMovement();
+	const bool bHitsPhysicsBody = OtherComp && OtherComp->IsSimulatingPhysics();
+	const bool bHitsWall = moveComponent->IsFalling() && Hit.ImpactNormal.Z < moveComponent->GetWalkableFloorZ();
+	if (bHitsPhysicsBody || bHitsWall)
+	{
+		const FVector velocity = moveComponent->Velocity;
+		EndKinematicFlight();
+		moveComponent->StopMovementImmediately();
+
+		UCapsuleComponent* capsule = GetCapsuleComponent();
+		capsule->SetSimulatePhysics(true);
+		capsule->SetPhysicsLinearVelocity(velocity);
+	}
 }
 
-void AGrabableEnemy::ThrownSlide()
+void AGrabableEnemy::EndKinematicFlight()
 {
-	if(GetVelocity().Length() <= stopSlidingVelocityThreshold)
+	if (!bKinematicFlight)
 	{
-		UCapsuleComponent* capsule = FindComponentByClass<UCapsuleComponent>();
-		capsule->SetSimulatePhysics(false);
-		GetWorldTimerManager().ClearTimer(thrownSlideHandle);
+		return;
+	}
+	bKinematicFlight = false;
+
+	GetCapsuleComponent()->OnComponentHit.RemoveDynamic(this, &AGrabableEnemy::OnKinematicThrowHit);
+
+	AAIController* controller = Cast<AAIController>(GetController());
+	if(controller)
+	{
+		controller->GetBrainComponent()->ResumeLogic("LetGo");
 	}
 }
 
@@ -213,11 +361,11 @@ void AGrabableEnemy::Explode()
 {
 	if(bExploded)
 		return;
+	bExploded = true;
 
-	UCapsuleComponent* capsule = FindComponentByClass<UCapsuleComponent>();
-	capsule->OnComponentHit.RemoveAll(this);
+	GetCapsuleComponent()->OnComponentHit.RemoveAll(this);
 	
-	auto player = Cast<ARCTCharacter>(UGameplayStatics::GetPlayerCharacter(GetWorld(), 0));
+	ARCTCharacter* player = GetCachedPlayer();
 	if(player != nullptr)
 	{
 		// TODO: explosionDmg and knockback force to player
@@ -228,17 +376,25 @@ void AGrabableEnemy::Explode()
 			ignoreActors.Add(this);
 		}
 
-		auto particleEffect = player->GetThrowExplosionParticleEffect();
-		if (particleEffect)
+		UCombatFeedbackSubsystem* feedback = GetWorld()->GetSubsystem<UCombatFeedbackSubsystem>();
+		if (feedback)
 		{
-			UNiagaraFunctionLibrary::SpawnSystemAtLocation(GetWorld(), particleEffect,
-				GetActorLocation());
+			// every explosion gets its own burst, two blasts side by side should look like two
+			feedback->QueueBurst(player->GetThrowExplosionParticleEffect(), GetActorLocation(), false);
 		}
-		UGameplayStatics::ApplyRadialDamage(GetWorld(), explosionDmg, GetActorLocation(),
-			player->GetThrowExplosionRadius(), UDamageType::StaticClass(), ignoreActors, this);
+
+		// resolved with the rest of the frame's blasts, enemies it sets off queue theirs behind it
+		UExplosionSubsystem* explosions = GetWorld()->GetSubsystem<UExplosionSubsystem>();
+		if (explosions)
+		{
+			explosions->QueueExplosion(GetActorLocation(), player->GetThrowExplosionRadius(), explosionDmg,
+				player->GetThrowKnockbackImpulse(), this, nullptr, ignoreActors);
+		}
+
+		// already drained empty, an enemy killed by its own blast goes in TakeDamage
 		if (health <= 0)
 		{
-			Destroy();
+			Despawn();
 		}
 	}
 	else
@@ -251,16 +407,14 @@ void AGrabableEnemy::FellOutOfWorld(const UDamageType& dmgType)
 {
 	if (health > 0) 
 	{
-		hpZeroEvent.Broadcast();
+		BroadcastHPZero();
 	}
 
 	Explode();
-	//Check health just to be safe
-	//if (health > 0) 
-	//{
-		//deathEvent.Broadcast();
-		//deathEvent.Clear();
-	//}
-
-	Super::FellOutOfWorld(dmgType);
+
+	// not Super, its Destroy would hit an enemy Explode already handed back to the pool
+	if (!bPooled)
+	{
+		Despawn();
+	}
 }
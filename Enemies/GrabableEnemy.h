@@ -9,6 +9,8 @@
 #include "GameFramework/Pawn.h"
 #include "GrabableEnemy.generated.h"
 
+class UStaticMeshComponent;
+
 UCLASS(Blueprintable, Category="RCT Enemies")
 class RCT_API AGrabableEnemy : public AEnemyBase, public IGrabableInterface
 {
@@ -16,7 +18,7 @@ class RCT_API AGrabableEnemy : public AEnemyBase, public IGrabableInterface
 
 public:
 	// Sets default values for this pawn's properties
-	AGrabableEnemy();
+	AGrabableEnemy(const FObjectInitializer& ObjectInitializer);
 	
 	void Grab_Implementation(ARCTCharacter* character) override;
 	UFUNCTION()
@@ -29,10 +31,39 @@ public:
 	UFUNCTION()
 	void HitByFist();
 
-	void ThrownSlide();
+	/** Turns the physics back off once UThrownEnemySubsystem finds the enemy slowed down enough */
+	void StopSliding();
+
+	float GetStopSlidingVelocityThreshold() const
+	{
+		return stopSlidingVelocityThreshold;
+	}
+
+	UFUNCTION(BlueprintCallable)
+	void Explode();
 
 	virtual float TakeDamage(float damageAmount, FDamageEvent const& damageEvent, AController* eventInstigator, AActor* damageCauser) override;
 
+	virtual void DeactivateForPool() override;
+
+	/** Held for a kinematic throw, Tick samples the hand's speed to launch us with */
+	virtual bool NeedsActorTick() const override;
+
+	virtual bool NeedsFullTickRate() const override;
+
+	/** In the air on a kinematic throw, the enemy can't settle before it lands */
+	bool IsAirborne() const;
+
+	/** Knockback on every static mesh of the enemy, from the component set cached at BeginPlay */
+	void ApplyExplosionImpulse(const FVector& origin, float radius, float strength);
+
+	/** Call after adding or removing static meshes at runtime, the next explosion caches them again */
+	UFUNCTION(BlueprintCallable)
+	void InvalidatePhysicsComponents()
+	{
+		bPhysicsComponentsDirty = true;
+	}
+
 protected:
 	// Called when the game starts or when spawned
 	virtual void BeginPlay() override;
@@ -48,25 +79,57 @@ protected:
 	UPROPERTY(BlueprintReadWrite)
 	float throwTimeToExplode = 0.5f;
 
-	UPROPERTY(VisibleAnywhere)
-	FTimerHandle thrownSlideHandle;
-
 	UPROPERTY(EditAnywhere, BlueprintReadWrite)
 	float stopSlidingVelocityThreshold;
 
+	/**
+	 * Throws fly on the movement component's swept capsule along a ballistic arc instead of a simulated body.
+	 * Physics only takes over when the enemy hits a wall or a simulated body in the air.
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	bool bKinematicThrow = false;
+
+	/** Custom primitive data slot of the mesh the materials read the grab highlight from, 0 or 1 */
+	UPROPERTY(EditDefaultsOnly, Category = "Grab", meta = (ClampMin = "0"))
+	int32 highlightPrimitiveDataIndex = 0;
+
 	UPROPERTY()
 	FName originalCollisionProfileName;
 
 	UFUNCTION()
 	void OverlapExplode(UPrimitiveComponent* HitComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, FVector NormalImpulse, const FHitResult& Hit);
 
-	UFUNCTION(BlueprintCallable)
-	void Explode();
+	UFUNCTION()
+	void OnKinematicThrowHit(UPrimitiveComponent* HitComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, FVector NormalImpulse, const FHitResult& Hit);
 
 	virtual void FellOutOfWorld(const UDamageType& dmgType) override;
 
+	/** Player cached at BeginPlay, looked up again if it was not possessed yet or got destroyed */
+	ARCTCharacter* GetCachedPlayer();
+
 private:
-	bool bExploded;
+	void CachePhysicsComponents();
+
+	void EndKinematicFlight();
+
+	bool bExploded = false;
+
+	bool bKinematicFlight = false;
+
+	bool bHighlighted = false;
+
+	FVector heldVelocity = FVector::ZeroVector;
+	FVector lastHeldLocation = FVector::ZeroVector;
+
+	UPROPERTY(Transient)
+	TArray<UStaticMeshComponent*> impulseComponents;
+
+	/** Owned component count when impulseComponents was built, a mismatch means components were added or removed */
+	int32 cachedComponentCount = 0;
+
+	bool bPhysicsComponentsDirty = false;
+
+	TWeakObjectPtr<ARCTCharacter> cachedPlayer;
 
 public:	
 	// Called every frame
@@ -0,0 +1,111 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Enemies/ThrownEnemySubsystem.h"
+
+#include "Enemies/GrabableEnemy.h"
+
+void UThrownEnemySubsystem::AddThrownEnemy(AGrabableEnemy* enemy, float fuse)
+{
+	if (enemy == nullptr)
+	{
+		return;
+	}
+
+	FThrownEnemy* thrown = thrownEnemies.FindByPredicate([enemy](const FThrownEnemy& existing)
+	{
+		return existing.enemy == enemy;
+	});
+	if (thrown == nullptr)
+	{
+		thrown = &thrownEnemies.AddDefaulted_GetRef();
+		thrown->enemy = enemy;
+	}
+
+	thrown->bSliding = true;
+	thrown->timeUntilSettleCheck = settleCheckInterval;
+	// a punch doesn't put out the fuse of an enemy already thrown
+	if (fuse > 0.f)
+	{
+		thrown->fuse = fuse;
+	}
+}
+
+void UThrownEnemySubsystem::RemoveThrownEnemy(AGrabableEnemy* enemy)
+{
+	thrownEnemies.RemoveAllSwap([enemy](const FThrownEnemy& thrown)
+	{
+		return thrown.enemy == enemy;
+	});
+}
+
+void UThrownEnemySubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	// Handled after the walk, exploding can pool the enemy and change the list
+	TArray<AGrabableEnemy*, TInlineAllocator<8>> settled;
+	TArray<AGrabableEnemy*, TInlineAllocator<8>> exploding;
+
+	for (int32 i = thrownEnemies.Num() - 1; i >= 0; i--)
+	{
+		FThrownEnemy& thrown = thrownEnemies[i];
+		AGrabableEnemy* enemy = thrown.enemy.Get();
+		if (enemy == nullptr || enemy->IsPooled())
+		{
+			thrownEnemies.RemoveAtSwap(i);
+			continue;
+		}
+
+		if (thrown.fuse > 0.f)
+		{
+			thrown.fuse -= DeltaTime;
+			if (thrown.fuse <= 0.f)
+			{
+				exploding.Add(enemy);
+			}
+		}
+
+		if (thrown.bSliding && !enemy->IsAirborne())
+		{
+			thrown.timeUntilSettleCheck -= DeltaTime;
+			if (thrown.timeUntilSettleCheck <= 0.f)
+			{
+				thrown.timeUntilSettleCheck = settleCheckInterval;
+				if (enemy->GetVelocity().SizeSquared() <= FMath::Square(enemy->GetStopSlidingVelocityThreshold()))
+				{
+					thrown.bSliding = false;
+					settled.Add(enemy);
+				}
+			}
+		}
+
+		if (!thrown.bSliding && thrown.fuse <= 0.f)
+		{
+			thrownEnemies.RemoveAtSwap(i);
+		}
+	}
+
+	for (AGrabableEnemy* enemy : settled)
+	{
+		enemy->StopSliding();
+	}
+
+	for (AGrabableEnemy* enemy : exploding)
+	{
+		if (IsValid(enemy) && !enemy->IsPooled())
+		{
+			enemy->Explode();
+		}
+	}
+}
+
+bool UThrownEnemySubsystem::IsTickable() const
+{
+	return thrownEnemies.Num() > 0;
+}
+
+TStatId UThrownEnemySubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UThrownEnemySubsystem, STATGROUP_Tickables);
+}
@@ -0,0 +1,46 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "ThrownEnemySubsystem.generated.h"
+
+class AGrabableEnemy;
+
+/**
+ * Grabable enemies sent flying by a throw or a punch. A single pass per frame turns the physics off on the ones
+ * that slowed down below their stopSlidingVelocityThreshold, checked every settleCheckInterval, and runs down
+ * the explosion fuse of thrown enemies, instead of timers set on every throw.
+ */
+UCLASS(Config = Game)
+class RCT_API UThrownEnemySubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	/** Tracks @enemy until it settles, exploding it after @fuse seconds unless @fuse <= 0 */
+	void AddThrownEnemy(AGrabableEnemy* enemy, float fuse);
+
+	void RemoveThrownEnemy(AGrabableEnemy* enemy);
+
+	virtual void Tick(float DeltaTime) override;
+	virtual bool IsTickable() const override;
+	virtual TStatId GetStatId() const override;
+
+protected:
+	UPROPERTY(Config)
+	float settleCheckInterval = 0.1f;
+
+private:
+	struct FThrownEnemy
+	{
+		TWeakObjectPtr<AGrabableEnemy> enemy;
+		float fuse = 0.f;
+		/** First check one interval after the throw, the launch impulse only shows up after the next physics step */
+		float timeUntilSettleCheck = 0.f;
+		bool bSliding = true;
+	};
+
+	TArray<FThrownEnemy> thrownEnemies;
+};
@@ -3,8 +3,198 @@
 
 #include "Interfaces/GrabableInterface.h"
 
+#include "EngineUtils.h"
+#include "HAL/IConsoleManager.h"
+#include "UObject/UObjectGlobals.h"
+
 // Add default functionality here for any IGrabableInterface functions that are not pure virtual.
 //
 //void IGrabableInterface::Grab(ARCTCharacter* character) {}
 //
 //void IGrabableInterface::LetGo(ARCTCharacter* character) {}
+
+namespace GrabableDispatch
+{
+	enum : uint8
+	{
+		NativeCanBeGrabbed = 1 << 0,
+		NativeIsGrabbed = 1 << 1,
+		NativeSetHilighting = 1 << 2,
+		ImplementsInterface = 1 << 3,
+	};
+
+	// Game thread only, like every caller
+	static TMap<const UClass*, uint8> classFlags;
+}
+
+uint8 IGrabableInterface::GetDispatchFlags(const UClass* objectClass)
+{
+	if (const uint8* flags = GrabableDispatch::classFlags.Find(objectClass))
+	{
+		return *flags;
+	}
+
+#if WITH_EDITOR
+	// recompiled Blueprints get a new class and the old one can be freed, start over
+	static FDelegateHandle reinstancedHandle = FCoreUObjectDelegates::OnObjectsReinstanced.AddLambda([](const FCoreUObjectDelegates::FReplacementObjectMap&)
+	{
+		GrabableDispatch::classFlags.Reset();
+	});
+#endif
+
+	uint8 flags = 0;
+	if (objectClass->ImplementsInterface(UGrabableInterface::StaticClass()))
+	{
+		flags |= GrabableDispatch::ImplementsInterface;
+
+		// A Blueprint override shows up as a non native function on the generated class
+		auto isNative = [objectClass](FName eventName)
+		{
+			const UFunction* function = objectClass->FindFunctionByName(eventName);
+			return function != nullptr && function->HasAnyFunctionFlags(FUNC_Native);
+		};
+		if (objectClass->GetDefaultObject()->GetNativeInterfaceAddress(UGrabableInterface::StaticClass()) != nullptr)
+		{
+			if (isNative(GET_FUNCTION_NAME_CHECKED(IGrabableInterface, CanBeGrabbed)))
+			{
+				flags |= GrabableDispatch::NativeCanBeGrabbed;
+			}
+			if (isNative(GET_FUNCTION_NAME_CHECKED(IGrabableInterface, IsGrabbed)))
+			{
+				flags |= GrabableDispatch::NativeIsGrabbed;
+			}
+			if (isNative(GET_FUNCTION_NAME_CHECKED(IGrabableInterface, SetHilighting)))
+			{
+				flags |= GrabableDispatch::NativeSetHilighting;
+			}
+		}
+	}
+
+	GrabableDispatch::classFlags.Add(objectClass, flags);
+	return flags;
+}
+
+IGrabableInterface* IGrabableInterface::GetNativeImplementer(UObject* object, uint8 nativeFlag)
+{
+	if ((GetDispatchFlags(object->GetClass()) & nativeFlag) == 0)
+	{
+		return nullptr;
+	}
+	return Cast<IGrabableInterface>(object);
+}
+
+bool IGrabableInterface::CanBeGrabbedFast(UObject* object)
+{
+	if (object == nullptr)
+	{
+		return false;
+	}
+	if (IGrabableInterface* nativeInterface = GetNativeImplementer(object, GrabableDispatch::NativeCanBeGrabbed))
+	{
+		return nativeInterface->CanBeGrabbed_Implementation();
+	}
+	if (GetDispatchFlags(object->GetClass()) & GrabableDispatch::ImplementsInterface)
+	{
+		return Execute_CanBeGrabbed(object);
+	}
+	return false;
+}
+
+bool IGrabableInterface::IsGrabbedFast(UObject* object)
+{
+	if (object == nullptr)
+	{
+		return false;
+	}
+	if (IGrabableInterface* nativeInterface = GetNativeImplementer(object, GrabableDispatch::NativeIsGrabbed))
+	{
+		return nativeInterface->IsGrabbed_Implementation();
+	}
+	if (GetDispatchFlags(object->GetClass()) & GrabableDispatch::ImplementsInterface)
+	{
+		return Execute_IsGrabbed(object);
+	}
+	return false;
+}
+
+void IGrabableInterface::SetHilightingFast(UObject* object, bool bIfHighlight)
+{
+	if (object == nullptr)
+	{
+		return;
+	}
+	if (IGrabableInterface* nativeInterface = GetNativeImplementer(object, GrabableDispatch::NativeSetHilighting))
+	{
+		nativeInterface->SetHilighting_Implementation(bIfHighlight);
+		return;
+	}
+	if (GetDispatchFlags(object->GetClass()) & GrabableDispatch::ImplementsInterface)
+	{
+		Execute_SetHilighting(object, bIfHighlight);
+	}
+}
+
+#if !UE_BUILD_SHIPPING
+// rct.BenchGrabableDispatch [Iterations]: times CanBeGrabbed/IsGrabbed through reflection vs the fast path
+// on up to 100 grabables of the current world
+static FAutoConsoleCommandWithWorldAndArgs GBenchGrabableDispatchCommand(
+	TEXT("rct.BenchGrabableDispatch"),
+	TEXT("Compares reflected and native IGrabableInterface dispatch on up to 100 grabables. Args: [Iterations=1000]"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& args, UWorld* world)
+	{
+		if (world == nullptr)
+		{
+			return;
+		}
+
+		const int32 iterations = args.Num() > 0 ? FMath::Max(1, FCString::Atoi(*args[0])) : 1000;
+
+		TArray<AActor*> grabables;
+		for (TActorIterator<AActor> it(world); it && grabables.Num() < 100; ++it)
+		{
+			if (it->GetClass()->ImplementsInterface(UGrabableInterface::StaticClass()))
+			{
+				grabables.Add(*it);
+			}
+		}
+
+		if (grabables.Num() == 0)
+		{
+			UE_LOG(LogTemp, Warning, TEXT("rct.BenchGrabableDispatch: no grabables in the world"));
+			return;
+		}
+
+		int32 grabbableCount = 0;
+		double start = FPlatformTime::Seconds();
+		for (int32 i = 0; i < iterations; i++)
+		{
+			for (AActor* actor : grabables)
+			{
+				if (actor->GetClass()->ImplementsInterface(UGrabableInterface::StaticClass())
+					&& IGrabableInterface::Execute_CanBeGrabbed(actor) && !IGrabableInterface::Execute_IsGrabbed(actor))
+				{
+					grabbableCount++;
+				}
+			}
+		}
+		const double reflectedTime = FPlatformTime::Seconds() - start;
+
+		start = FPlatformTime::Seconds();
+		for (int32 i = 0; i < iterations; i++)
+		{
+			for (AActor* actor : grabables)
+			{
+				if (IGrabableInterface::CanBeGrabbedFast(actor) && !IGrabableInterface::IsGrabbedFast(actor))
+				{
+					grabbableCount--;
+				}
+			}
+		}
+		const double fastTime = FPlatformTime::Seconds() - start;
+
+		const double callCount = static_cast<double>(iterations) * grabables.Num();
+		UE_LOG(LogTemp, Display, TEXT("rct.BenchGrabableDispatch: %d grabables x %d iterations, reflected %.1f ns/candidate, fast %.1f ns/candidate (%.2fx)%s"),
+			grabables.Num(), iterations, reflectedTime * 1e9 / callCount, fastTime * 1e9 / callCount,
+			fastTime > 0.0 ? reflectedTime / fastTime : 0.0, grabbableCount != 0 ? TEXT(", results differ!") : TEXT(""));
+	}));
+#endif
@@ -32,4 +32,24 @@ public:
 
 	UFUNCTION(BlueprintCallable, BlueprintNativeEvent)
 	bool CanBeGrabbed();
+
+	UFUNCTION(BlueprintCallable, BlueprintNativeEvent)
+	bool IsGrabbed();
+
+	UFUNCTION(BlueprintCallable, BlueprintNativeEvent)
+	void SetHilighting(bool bIfHighlight);
+
+	// Hot path versions of the Execute_ calls: call the _Implementation directly when the object implements
+	// the interface in C++ and its Blueprint doesn't override the event, go through reflection otherwise.
+	// Objects not implementing the interface are treated as not grabbable.
+	static bool CanBeGrabbedFast(UObject* object);
+	static bool IsGrabbedFast(UObject* object);
+	static void SetHilightingFast(UObject* object, bool bIfHighlight);
+
+private:
+	/** The _Implementation to call directly for the event in @nativeFlag, null when it has to go through reflection */
+	static IGrabableInterface* GetNativeImplementer(UObject* object, uint8 nativeFlag);
+
+	/** Which events the class leaves native and whether it implements the interface at all, resolved once per class */
+	static uint8 GetDispatchFlags(const UClass* objectClass);
 };
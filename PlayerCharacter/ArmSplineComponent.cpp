@@ -3,15 +3,17 @@
 #include "ArmSplineComponent.h"
 
 #include "DynamicCameraShake.h"
-#include "NiagaraFunctionLibrary.h"
 #include "Components/CapsuleComponent.h"
 #include "Enemies/GrabableEnemy.h"
 #include "Engine/ICookInfo.h"
 #include "GameFramework/Character.h"
 #include "Kismet/GameplayStatics.h"
+#include "Sound/SoundBase.h"
 #include "PlayerCharacter/RCTCharacter.h"
 #include "Components/SplineMeshComponent.h"
 #include "Components/TimelineComponent.h"
+#include "Systems/CameraShakeSubsystem.h"
+#include "Systems/DamageQueueSubsystem.h"
 
 UArmSplineComponent::UArmSplineComponent()
 {
@@ -236,24 +238,43 @@ FVector UArmSplineComponent::CalculateCurvePoint(float tValue, FVector& position
 
 UNiagaraSystem* UArmSplineComponent::GetArmHitParticleEffect() const
 {
-	return ArmHitParticleEffect;
+	// already in memory once the level's preload is done, loads it on the spot otherwise
+	return ArmHitParticleEffect.LoadSynchronous();
+}
+
+void UArmSplineComponent::GetCombatAssets(TArray<FSoftObjectPath>& outPaths) const
+{
+	outPaths.AddUnique(ArmHitParticleEffect.ToSoftObjectPath());
+	outPaths.AddUnique(ArmHitSound.ToSoftObjectPath());
+	outPaths.AddUnique(armHitCamShake.ToSoftObjectPath());
 }
 
 
 void UArmSplineComponent::OnEnemyOverlaped_Implementation(AEnemyBase* enemy)
 {
-	enemy->TakeDamage(ArmDamageMultiplier * ArmHitDamage, FPointDamageEvent(), PlayerCharacter->GetInstigatorController(), PlayerCharacter);
+	// resolved after physics with the rest of the frame's damage, not inside the overlap callback
+	if(UDamageQueueSubsystem* damageQueue = GetWorld()->GetSubsystem<UDamageQueueSubsystem>())
+	{
+		FQueuedDamageFeedback feedback;
+		feedback.hitEffect = GetArmHitParticleEffect();
+		feedback.hitSound = ArmHitSound.LoadSynchronous();
+		damageQueue->QueueDamage(enemy, ArmDamageMultiplier * ArmHitDamage, PlayerCharacter->GetInstigatorController(), PlayerCharacter, feedback);
+	}
 	enemy->Stun();
-	UNiagaraFunctionLibrary::SpawnSystemAtLocation( GetWorld(), ArmHitParticleEffect, enemy->GetTransform().GetLocation());
-	UGameplayStatics::PlaySound2D(GetWorld(), ArmHitSound);
-	armHitEvent.Broadcast(enemy);
+	if(armHitEvent.IsBound())
+	{
+		armHitEvent.Broadcast(enemy);
+	}
 	
-	if(armHitCamShake)
+	if(!armHitCamShake.IsNull())
 	{
 		if(HitPredict != FVector2D::Zero())
 		{
-			UDynamicCameraShake::UpdateCamShake(armHitCamShake, HitPredict);
-			UGameplayStatics::PlayWorldCameraShake(this, armHitCamShake, enemy->GetActorLocation(), 0, 50000, 1, true);
+			// hits of the same sweep get merged into one shake at the end of the frame
+			if(UCameraShakeSubsystem* shakeSubsystem = GetWorld()->GetSubsystem<UCameraShakeSubsystem>())
+			{
+				shakeSubsystem->QueueShake(armHitCamShake.LoadSynchronous(), enemy->GetActorLocation(), HitPredict);
+			}
 		}
 		else
 		{
@@ -283,7 +304,7 @@ void UArmSplineComponent::OnOverlapBegin(class UPrimitiveComponent* OverlappedCo
 	// DrawDebugString(GetWorld(), OtherActor->GetActorLocation(), AActor::GetDebugName(OtherActor), nullptr, FColor::Yellow, 6.0f, true);
 	// DrawDebugString(GetWorld(), OtherActor->GetActorLocation(), OtherComp->GetName(), nullptr, FColor::Yellow, 6.0f, true);
 	
-	if (OtherActor->GetClass()->ImplementsInterface(UGrabableInterface::StaticClass()) && !IGrabableInterface::Execute_IsGrabbed(OtherActor))
+	if (OtherActor->GetClass()->ImplementsInterface(UGrabableInterface::StaticClass()) && !IGrabableInterface::IsGrabbedFast(OtherActor))
 	{
 		// Arm Hit
 		if(AEnemyBase* enemy = Cast<AEnemyBase>(OtherActor))
@@ -294,7 +315,7 @@ void UArmSplineComponent::OnOverlapBegin(class UPrimitiveComponent* OverlappedCo
 
 				
 				OnEnemyOverlaped(enemy);
-				enemy->TakePeriodicDamage(ArmStayDamage, ArmStayDamageTimeInterval);
+				enemy->TakePeriodicDamage(ArmStayDamage, ArmStayDamageTimeInterval, PlayerCharacter);
 			}
 			else
 			{
@@ -306,7 +327,7 @@ void UArmSplineComponent::OnOverlapBegin(class UPrimitiveComponent* OverlappedCo
 
 void UArmSplineComponent::OnOverlapEnd(UPrimitiveComponent* OverlappedComp, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex)
 {
-	if (OtherActor->GetClass()->ImplementsInterface(UGrabableInterface::StaticClass()) && !IGrabableInterface::Execute_IsGrabbed(OtherActor))
+	if (OtherActor->GetClass()->ImplementsInterface(UGrabableInterface::StaticClass()) && !IGrabableInterface::IsGrabbedFast(OtherActor))
 	{
 		// Arm Hit
 		if(AEnemyBase* enemy = Cast<AEnemyBase>(OtherActor))
@@ -65,12 +65,13 @@ public:
 		float ArmStayDamage = 0.2f;
 	UPROPERTY(BlueprintReadWrite, Category="ArmHit")
 		float ArmStayDamageTimeInterval = 0.f;
+	/** Soft so UCombatPreloadSubsystem loads it during the level transition, see GetCombatAssets */
 	UPROPERTY(EditDefaultsOnly, BlueprintReadWrite, Category = "ArmHit")
-		UNiagaraSystem* ArmHitParticleEffect;
+		TSoftObjectPtr<UNiagaraSystem> ArmHitParticleEffect;
 	UPROPERTY(EditDefaultsOnly, BlueprintReadWrite, Category = "ArmHit")
-		USoundBase* ArmHitSound;
+		TSoftObjectPtr<USoundBase> ArmHitSound;
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "ArmHit")
-		TSubclassOf<UDynamicCameraShake> armHitCamShake;
+		TSoftClassPtr<UDynamicCameraShake> armHitCamShake;
 
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Positions")
 		ARCTCharacter* PlayerCharacter;
@@ -185,6 +186,9 @@ public:
 	
 	UFUNCTION(BlueprintCallable, BlueprintPure)
 	UNiagaraSystem* GetArmHitParticleEffect() const;
+
+	/** Soft references of the arm hit effect, sound and camera shake, for the preload manifest */
+	void GetCombatAssets(TArray<FSoftObjectPath>& outPaths) const;
 	
 	UFUNCTION(BlueprintNativeEvent)
 	void OnEnemyOverlaped(AEnemyBase* enemy);
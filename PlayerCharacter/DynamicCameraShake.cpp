@@ -3,8 +3,6 @@
 
 #include "DynamicCameraShake.h"
 
-#include "Kismet/GameplayStatics.h"
-
 UDynamicCameraShake::UDynamicCameraShake()
 {
 	OscillationDuration = 0.17f;
@@ -25,14 +23,14 @@ UDynamicCameraShake::UDynamicCameraShake()
 
 	LocOscillation.Z.Amplitude = 0;
 	LocOscillation.Z.Frequency = 10;
+
+	// restart the running shake instead of stacking a new instance for every hit
+	bSingleInstance = true;
 }
 
-void UDynamicCameraShake::UpdateCamShake(TSubclassOf<UDynamicCameraShake> shakeClass, FVector2D shakeVector)
+void UDynamicCameraShake::ApplyShakeParams(const FDynamicCameraShakeParams& params)
 {
-	if (UDynamicCameraShake* CDO = Cast<UDynamicCameraShake>(shakeClass->GetDefaultObject()))
-	{
-		shakeVector = shakeVector.GetSafeNormal() * 20.0f;
-		CDO->LocOscillation.Y.Amplitude = shakeVector.X;
-		CDO->LocOscillation.Z.Amplitude = shakeVector.Y;
-	}
+	FVector2D shakeVector = params.direction.GetSafeNormal() * params.amplitude;
+	LocOscillation.Y.Amplitude = shakeVector.X;
+	LocOscillation.Z.Amplitude = shakeVector.Y;
 }
\ No newline at end of file
@@ -6,6 +6,15 @@
 #include "MatineeCameraShake.h"
 #include "DynamicCameraShake.generated.h"
 
+/** Per play parameters, applied to the shake instance so the class defaults are never touched */
+struct FDynamicCameraShakeParams
+{
+	/** Screen space direction of the shake, gets normalized */
+	FVector2D direction = FVector2D::Zero();
+
+	float amplitude = 20.0f;
+};
+
 /**
  * 
  */
@@ -17,6 +26,5 @@ class RCT_API UDynamicCameraShake : public UMatineeCameraShake
 public:
 	UDynamicCameraShake();
 
-	// UFUNCTION(BlueprintCallable)
-	static void UpdateCamShake(TSubclassOf<UDynamicCameraShake> shakeClass, FVector2D shakeVector);
+	void ApplyShakeParams(const FDynamicCameraShakeParams& params);
 };
@@ -30,6 +30,8 @@
 #include "Components/SphereComponent.h"
 #include "Engine/BlockingVolume.h"
 #include "Kismet/KismetMathLibrary.h"
+#include "PlayerCharacter/RCTPlayerController.h"
+#include "Systems/GameplayEventSubsystem.h"
 
 
 // Sets default values
@@ -79,6 +81,29 @@ void ARCTCharacter::BeginPlay()
 {
 	Super::BeginPlay();
 	OnTakeAnyDamage.AddDynamic(this, &ARCTCharacter::PlayerDamage);
+
+	hudNotifications = GetWorld()->GetSubsystem<UHUDNotificationSubsystem>();
+	if (hudNotifications)
+	{
+		FHUDAttributeChangedDelegate callback;
+		callback.BindUFunction(this, GET_FUNCTION_NAME_CHECKED(ARCTCharacter, OnHealthNotification));
+		hudNotifications->RegisterListener(this, TEXT("Health"), callback);
+	}
+
+	if (UGameplayEventSubsystem* gameplayEvents = GetWorld()->GetSubsystem<UGameplayEventSubsystem>())
+	{
+		enemyHPZeroHandle = gameplayEvents->onEnemyHPZero.AddUObject(this, &ARCTCharacter::OnEnemyHPZero);
+	}
+}
+
+void ARCTCharacter::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (UGameplayEventSubsystem* gameplayEvents = GetWorld()->GetSubsystem<UGameplayEventSubsystem>())
+	{
+		gameplayEvents->onEnemyHPZero.Remove(enemyHPZeroHandle);
+	}
+
+	Super::EndPlay(EndPlayReason);
 }
 
 void ARCTCharacter::PostInitializeComponents()
@@ -88,6 +113,8 @@ void ARCTCharacter::PostInitializeComponents()
 	grabRangeCollision->OnComponentEndOverlap.AddDynamic(this, &ARCTCharacter::OnActorExitArmRange);
 
 	handTarget->OnComponentHit.AddDynamic(this, &ARCTCharacter::OnHandTargetHit);
+	// bound for good, the fist only overlaps anything while its profile isn't NoCollision
+	punchCollision->OnComponentBeginOverlap.AddDynamic(this, &ARCTCharacter::OnFistBeginOverlap);
 }
 
 
@@ -95,6 +122,12 @@ void ARCTCharacter::PostInitializeComponents()
 void ARCTCharacter::Tick(float DeltaTime)
 {
 	Super::Tick(DeltaTime);
+
+	ARCTPlayerController* playerController = Cast<ARCTPlayerController>(Controller);
+	if (playerController)
+	{
+		ConsumeInputFrame(playerController->GetInputFrame());
+	}
 		
 	if (ability)
 	{
@@ -145,20 +178,14 @@ bool ARCTCharacter::CanDamage(UPrimitiveComponent* hitComponent)
 void ARCTCharacter::UpdateGrabTarget()
 {
 	float currentMinAngle = 361.0f;// max Angle
-	if(grabTarget)
-	{
-		if(grabTarget->GetClass()->ImplementsInterface(UGrabableInterface::StaticClass()))
-		{
-			IGrabableInterface::Execute_SetHilighting(grabTarget, false);
-		}
-		grabTarget = nullptr;
-	}
+	AActor* previousGrabTarget = grabTarget;
+	grabTarget = nullptr;
 
 	auto findClosestActorInRange = [&] (TSet<AActor*>& actorsInRange)
 	{
 		for (AActor* actor : actorsInRange)
 		{
-			if (actor->GetClass()->ImplementsInterface(UGrabableInterface::StaticClass()) && IGrabableInterface::Execute_CanBeGrabbed(actor))
+			if (IGrabableInterface::CanBeGrabbedFast(actor))
 			{
 				float gazeYaw = UKismetMathLibrary::FindLookAtRotation(GetActorLocation(), GetHandTargetLocation()).Yaw;
 				float enemyYaw = UKismetMathLibrary::FindLookAtRotation(GetActorLocation(), actor->GetActorLocation()).Yaw;
@@ -180,9 +207,14 @@ void ARCTCharacter::UpdateGrabTarget()
 		findClosestActorInRange(grabableObjectsInRange);
 	}
 
-	if(grabTarget && grabTarget->GetClass()->ImplementsInterface(UGrabableInterface::StaticClass()))
+	// only touch the highlight when the target changes
+	if(grabTarget != previousGrabTarget)
 	{
-		IGrabableInterface::Execute_SetHilighting(grabTarget, true);
+		if(IsValid(previousGrabTarget))
+		{
+			IGrabableInterface::SetHilightingFast(previousGrabTarget, false);
+		}
+		IGrabableInterface::SetHilightingFast(grabTarget, true);
 	}
 }
 
@@ -225,7 +257,17 @@ float ARCTCharacter::GetThrowExplosionDamage() const
 
 UNiagaraSystem* ARCTCharacter::GetThrowExplosionParticleEffect() const
 {
-	return throwExplosionParticleEffect;
+	// already in memory once the level's preload is done, loads it on the spot otherwise
+	return throwExplosionParticleEffect.LoadSynchronous();
+}
+
+void ARCTCharacter::GetCombatAssets(TArray<FSoftObjectPath>& outPaths) const
+{
+	outPaths.AddUnique(throwExplosionParticleEffect.ToSoftObjectPath());
+	if (armSplineComp)
+	{
+		armSplineComp->GetCombatAssets(outPaths);
+	}
 }
 
 #pragma endregion
@@ -236,7 +278,7 @@ void ARCTCharacter::PlayerDamage(AActor* DamagedActor, float Damage, const UDama
 {
 	if (curInvincibilityDuration <= 0) {
 		health -= Damage;
-		OnHealthChange(-Damage);
+		NotifyHealthChange(-Damage);
 
 		curInvincibilityDuration = hitInvincibilityDuration;
 	}
@@ -249,9 +291,32 @@ void ARCTCharacter::PlayerDamage(AActor* DamagedActor, float Damage, const UDama
 
 void ARCTCharacter::AbsorbAfterDamaging(float damageDealt) 
 {
-	health += damageDealt * DevourHPStealPercent / 100.f;
+	float absorbed = damageDealt * DevourHPStealPercent / 100.f;
+	if (absorbed == 0.f)
+	{
+		return;
+	}
+
+	health += absorbed;
 	health = FMath::Clamp(health, 0, maxHealth);
-	OnHealthChange(damageDealt * DevourHPStealPercent / 100.f);
+	NotifyHealthChange(absorbed);
+}
+
+void ARCTCharacter::NotifyHealthChange(float modifier)
+{
+	if (hudNotifications)
+	{
+		hudNotifications->QueueAttributeDelta(TEXT("Health"), modifier, health);
+	}
+	else
+	{
+		OnHealthChange(modifier);
+	}
+}
+
+void ARCTCharacter::OnHealthNotification(const FHUDAttributeUpdate& update)
+{
+	OnHealthChange(update.delta);
 }
 
 void ARCTCharacter::OnHealthChange_Implementation(float modifier) {};
@@ -442,16 +507,12 @@ void ARCTCharacter::UpdateHandTargetLocation()
 				armSplineComp->StartDevourBulgeTimeline();
 			}
 
-			if(grabTarget->GetClass()->ImplementsInterface(UGrabableInterface::StaticClass()))
-			{
-				IGrabableInterface::Execute_SetHilighting(grabTarget, false);
-			}
+			IGrabableInterface::SetHilightingFast(grabTarget, false);
 
 			grabTarget = nullptr;
 
 			realHand->SetCollisionProfileName(FName("BlockAllDynamic"));
 			punchCollision->SetCollisionProfileName(FName("BlockAllDynamic"));
-			punchCollision->OnComponentBeginOverlap.AddUniqueDynamic(this, &ARCTCharacter::OnFistBeginOverlap);
 		}
 	}
 	else
@@ -489,16 +550,37 @@ void ARCTCharacter::MultiplyHandSize(float scale)
 	realHand->SetRelativeScale3D(size * scale);
 }
 
-bool pushing = false;
+void ARCTCharacter::ConsumeInputFrame(const FRCTInputFrame& frame)
+{
+	rightStickInputLocation = frame.arm;
+
+	// a stale frame (controller didn't tick this frame) must not replay its actions
+	if (frame.frameNumber != GFrameCounter)
+	{
+		return;
+	}
+
+	if (frame.bGrabPressed)
+	{
+		Grab();
+	}
+	if (frame.bDevourPressed)
+	{
+		Devour();
+	}
+	if (frame.bGrabReleased)
+	{
+		LetGo();
+	}
+}
+
 void ARCTCharacter::UpdateArmX(float value)
 {
-	pushing = true;
 	rightStickInputLocation = FVector2D(value, rightStickInputLocation.Y);
 }
 
 void ARCTCharacter::UpdateArmY(float value)
 {
-	pushing = true;
 	rightStickInputLocation = FVector2D(rightStickInputLocation.X, value);
 }
 
@@ -551,7 +633,6 @@ void ARCTCharacter::Grab()
 		// not targeting any enemy feel free to punch
 		realHand->SetCollisionProfileName(FName("BlockAllDynamic"));
 		punchCollision->SetCollisionProfileName(FName("BlockAllDynamic"));
-		punchCollision->OnComponentBeginOverlap.AddUniqueDynamic(this, &ARCTCharacter::OnFistBeginOverlap);
 	}
 	
 	OnGrab();
@@ -605,10 +686,7 @@ void ARCTCharacter::LetGo()
 				controller->GetBrainComponent()->ResumeLogic("UnGrabTargeted");
 			}
 		}
-		if(grabTarget->GetClass()->ImplementsInterface(UGrabableInterface::StaticClass()))
-		{
-			IGrabableInterface::Execute_SetHilighting(grabTarget, false);
-		}
+		IGrabableInterface::SetHilightingFast(grabTarget, false);
 		grabTarget = nullptr;
 	}
 
@@ -623,7 +701,6 @@ void ARCTCharacter::LetGo()
 	}
 	realHand->SetCollisionProfileName(FName("NoCollision"));
 	punchCollision->SetCollisionProfileName(FName("NoCollision"));
-	punchCollision->OnComponentBeginOverlap.RemoveDynamic(this, &ARCTCharacter::OnFistBeginOverlap);
 }
 
 void ARCTCharacter::HandleDeathCase()
@@ -639,7 +716,19 @@ void ARCTCharacter::OnFistBeginOverlap(UPrimitiveComponent * overlappedComp, AAc
 	if (enemy != nullptr)
 	{
 		enemy->HitByFist();
-		playerPunchEvent.Broadcast(overlappedComp, otherActor, otherComp, otherBodyIndex, bFromSweep, sweepResult);
+
+		if (playerPunchEvent.IsBound())
+		{
+			playerPunchEvent.Broadcast(overlappedComp, otherActor, otherComp, otherBodyIndex, bFromSweep, sweepResult);
+		}
+	}
+}
+
+void ARCTCharacter::OnEnemyHPZero(const FEnemyGameplayEvent& event)
+{
+	if (event.enemy != nullptr && event.enemy == grabbedActor)
+	{
+		PromptForDevour();
 	}
 }
 
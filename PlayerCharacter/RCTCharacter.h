@@ -7,6 +7,8 @@
 #include "CoreMinimal.h"
 #include "ArmSplineComponent.h"
 #include "SkeleArmComponent.h"
+#include "RCTInputFrame.h"
+#include "Systems/HUDNotificationSubsystem.h"
 #include "GameFramework/Character.h"
 #include "RCTCharacter.generated.h"
 
@@ -33,6 +35,7 @@ public:
 protected:
 	// Called when the game starts or when spawned
 	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 	virtual void PostInitializeComponents() override;
 
 public:
@@ -61,6 +64,7 @@ public:
 	UFUNCTION(BlueprintNativeEvent)
 	void OnLetGo();
 
+	/** Fired at most once per frame with the summed health change of that frame */
 	UFUNCTION(BlueprintNativeEvent)
 	void OnHealthChange(float modifier);
 
@@ -70,6 +74,9 @@ public:
 	UFUNCTION(BlueprintCallable)
 	void EndPromptForDevour();
 
+	/** Applies the arm and actions the controller gathered this frame, called at the start of Tick. The controller applies the move axes itself */
+	void ConsumeInputFrame(const FRCTInputFrame& frame);
+
 	UFUNCTION(BlueprintCallable)
 	void UpdateArmX(float value);
 
@@ -106,6 +113,9 @@ public:
 	UFUNCTION(BlueprintCallable, BlueprintPure)
 	UNiagaraSystem* GetThrowExplosionParticleEffect() const;
 
+	/** Soft references of the character's and its arm's combat effects, for the preload manifest */
+	void GetCombatAssets(TArray<FSoftObjectPath>& outPaths) const;
+
 	UFUNCTION(BlueprintCallable)
 	void Devour();
 
@@ -238,8 +248,9 @@ protected:
 	UPROPERTY(EditDefaultsOnly, BlueprintReadWrite, Category = "Throw and Explosion")
 	float throwExplosionDamage = 1;
 
+	/** Soft so UCombatPreloadSubsystem loads it during the level transition, see GetCombatAssets */
 	UPROPERTY(EditDefaultsOnly, BlueprintReadWrite, Category = "Throw and Explosion")
-	UNiagaraSystem* throwExplosionParticleEffect;
+	TSoftObjectPtr<UNiagaraSystem> throwExplosionParticleEffect;
 
 	UPROPERTY(EditDefaultsOnly, BlueprintReadWrite, Category = "Throw and Explosion")
 	bool bIfApplyExplosionDamageToInstigator = true;
@@ -332,6 +343,20 @@ protected:
 
 	bool bShouldAutomateHand = true;
 
+	UPROPERTY()
+	class UHUDNotificationSubsystem* hudNotifications;
+
+	/** Queues the change for the end of frame HUD update instead of firing OnHealthChange right away */
+	void NotifyHealthChange(float modifier);
+
+	UFUNCTION()
+	void OnHealthNotification(const FHUDAttributeUpdate& update);
+
+	/** Subscribed once to UGameplayEventSubsystem, prompts for devour when the enemy in our hand runs out of health */
+	void OnEnemyHPZero(const struct FEnemyGameplayEvent& event);
+
+	FDelegateHandle enemyHPZeroHandle;
+
 private:
 	float curInvincibilityDuration = 0.f;
 	bool readyToDevour = false; // Whether or not the enemy in the player's hand is ready to be devoured
@@ -0,0 +1,44 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "RCTInputFrame.generated.h"
+
+/**
+ * Everything the player pressed or pushed during one frame, gathered by ARCTPlayerController.
+ * The move axes are applied by the controller, the rest is consumed by ARCTCharacter at the start of its tick
+ */
+USTRUCT(BlueprintType)
+struct RCT_API FRCTInputFrame
+{
+	GENERATED_BODY()
+
+	UPROPERTY(BlueprintReadOnly, Category = "Input")
+	FVector2D arm = FVector2D::Zero();
+
+	UPROPERTY(BlueprintReadOnly, Category = "Input")
+	FVector2D move = FVector2D::Zero();
+
+	UPROPERTY(BlueprintReadOnly, Category = "Input")
+	bool bGrabPressed = false;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Input")
+	bool bGrabReleased = false;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Input")
+	bool bDevourPressed = false;
+
+	/** FPlatformTime::Seconds() when the frame was gathered */
+	UPROPERTY(BlueprintReadOnly, Category = "Input")
+	double sampleTime = 0.0;
+
+	uint64 frameNumber = 0;
+
+	void ClearActions()
+	{
+		bGrabPressed = false;
+		bGrabReleased = false;
+		bDevourPressed = false;
+	}
+};
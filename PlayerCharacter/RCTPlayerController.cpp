@@ -13,8 +13,7 @@ void ARCTPlayerController::OnPossess(APawn* InPawn)
 {
 	Super::OnPossess(InPawn);
 
-	myPawn = Cast<ARCTCharacter>(InPawn);
-	//myPawn->OnDestroyed.AddDynamic(this, &ARCTPlayerController::PossessedPawnDestroyed);
+	//InPawn->OnDestroyed.AddDynamic(this, &ARCTPlayerController::PossessedPawnDestroyed);
 }
 
 void ARCTPlayerController::SetupInputComponent()
@@ -31,42 +30,56 @@ void ARCTPlayerController::SetupInputComponent()
 	InputComponent->BindAxis("YMovement", this, &ARCTPlayerController::MoveY);
 }
 
-void ARCTPlayerController::ArmX(float value)
+void ARCTPlayerController::PlayerTick(float DeltaTime)
 {
-	if(myPawn)
-	myPawn->UpdateArmX(value);
+	// actions only live for the frame they were pressed in, axes are rewritten by ProcessPlayerInput
+	inputFrame.ClearActions();
+
+	Super::PlayerTick(DeltaTime);
+
+	inputFrame.sampleTime = FPlatformTime::Seconds();
+	inputFrame.frameNumber = GFrameCounter;
+
+	// the movement component ticks before the character, movement input added in the character's tick would wait a frame
+	if (ARCTCharacter* character = Cast<ARCTCharacter>(GetPawn()))
+	{
+		character->UpdateMoveX(inputFrame.move.X);
+		character->UpdateMoveY(inputFrame.move.Y);
 	}
+}
+
+void ARCTPlayerController::ArmX(float value)
+{
+	inputFrame.arm.X = value;
+}
 
 void ARCTPlayerController::ArmY(float value)
 {
-	if (myPawn)
-	myPawn->UpdateArmY(value);
+	inputFrame.arm.Y = value;
 }
 
 void ARCTPlayerController::MoveX(float value)
 {
-	if (myPawn)
-	myPawn->UpdateMoveX(value);
+	inputFrame.move.X = value;
 }
 
 void ARCTPlayerController::MoveY(float value)
 {
-	if (myPawn)
-	myPawn->UpdateMoveY(value);
+	inputFrame.move.Y = value;
 }
 
 void ARCTPlayerController::Grab()
 {
-	myPawn->Grab();
+	inputFrame.bGrabPressed = true;
 }
 
 void ARCTPlayerController::LetGo()
 {
-	myPawn->LetGo();
+	inputFrame.bGrabReleased = true;
 }
 
 void ARCTPlayerController::Devour() {
-	myPawn->Devour();
+	inputFrame.bDevourPressed = true;
 }
 
 void ARCTPlayerController::PossessedPawnDestroyed(AActor* act)
@@ -3,6 +3,7 @@
 #pragma once
 
 #include "CoreMinimal.h"
+#include "RCTInputFrame.h"
 #include "GameFramework/PlayerController.h"
 #include "RCTPlayerController.generated.h"
 
@@ -17,6 +18,7 @@ public:
 
 	virtual void OnPossess(APawn* InPawn) override;
 	virtual void SetupInputComponent() override;
+	virtual void PlayerTick(float DeltaTime) override;
 
 	void ArmX(float value);
 	void ArmY(float value);
@@ -26,12 +28,18 @@ public:
 	void LetGo();
 	void Devour();
 
+	/** Input gathered during this frame's PlayerTick, the move axes are already applied to the pawn by then */
+	const FRCTInputFrame& GetInputFrame() const
+	{
+		return inputFrame;
+	}
+
 	UPROPERTY(BlueprintReadWrite)
 	bool bRestartOnDestroy = true;
 
 private:
 	UPROPERTY(BlueprintReadOnly, meta = (AllowPrivateAccess = "true"))
-	class ARCTCharacter* myPawn;
+	FRCTInputFrame inputFrame;
 
 	UFUNCTION()
 	void PossessedPawnDestroyed(AActor* act);
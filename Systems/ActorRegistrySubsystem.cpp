@@ -0,0 +1,225 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Systems/ActorRegistrySubsystem.h"
+
+#include "Enemies/EnemyBase.h"
+#include "Kismet/GameplayStatics.h"
+#include "Objects/LevelTransitionVolumeBase.h"
+
+void UActorRegistrySubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	actorSpawnedHandle = GetWorld()->AddOnActorSpawnedHandler(
+		FOnActorSpawned::FDelegate::CreateUObject(this, &UActorRegistrySubsystem::OnActorSpawned));
+	levelAddedHandle = FWorldDelegates::LevelAddedToWorld.AddUObject(this, &UActorRegistrySubsystem::OnLevelAddedToWorld);
+}
+
+void UActorRegistrySubsystem::Deinitialize()
+{
+	GetWorld()->RemoveOnActorSpawnedHandler(actorSpawnedHandle);
+	FWorldDelegates::LevelAddedToWorld.Remove(levelAddedHandle);
+
+	singletons.Empty();
+	missingSingletons.Empty();
+	liveEnemies.Empty();
+	crowdEnemyCount = 0;
+	queuedEnemyCount = 0;
+
+	Super::Deinitialize();
+}
+
+void UActorRegistrySubsystem::RegisterSingleton(AActor* actor, TSubclassOf<AActor> asClass)
+{
+	if (actor == nullptr)
+	{
+		return;
+	}
+
+	UClass* key = asClass ? asClass.Get() : actor->GetClass();
+	singletons.Add(key, actor);
+	missingSingletons.Remove(key);
+}
+
+void UActorRegistrySubsystem::UnregisterSingleton(AActor* actor)
+{
+	for (auto it = singletons.CreateIterator(); it; ++it)
+	{
+		if (it.Value() == actor)
+		{
+			it.RemoveCurrent();
+		}
+	}
+}
+
+AActor* UActorRegistrySubsystem::FindSingleton(TSubclassOf<AActor> actorClass)
+{
+	if (!actorClass)
+	{
+		return nullptr;
+	}
+
+	if (TWeakObjectPtr<AActor>* entry = singletons.Find(actorClass))
+	{
+		if (entry->IsValid())
+		{
+			return entry->Get();
+		}
+		singletons.Remove(actorClass);
+	}
+	else if (missingSingletons.Contains(actorClass))
+	{
+		return nullptr;
+	}
+
+	AActor* actor = UGameplayStatics::GetActorOfClass(GetWorld(), actorClass);
+	if (actor)
+	{
+		singletons.Add(actorClass, actor);
+	}
+	else
+	{
+		missingSingletons.Add(actorClass);
+	}
+	return actor;
+}
+
+void UActorRegistrySubsystem::OnActorSpawned(AActor* actor)
+{
+	for (auto it = missingSingletons.CreateIterator(); it; ++it)
+	{
+		if (actor->IsA(*it))
+		{
+			singletons.Add(*it, actor);
+			it.RemoveCurrent();
+		}
+	}
+}
+
+void UActorRegistrySubsystem::OnLevelAddedToWorld(ULevel* level, UWorld* world)
+{
+	if (world == GetWorld())
+	{
+		missingSingletons.Empty();
+	}
+}
+
+void UActorRegistrySubsystem::RegisterEnemy(AEnemyBase* enemy)
+{
+	bool bAlreadyRegistered = false;
+	liveEnemies.Add(enemy, &bAlreadyRegistered);
+	if (bAlreadyRegistered)
+	{
+		return;
+	}
+
+	if (ALevelTransitionVolumeBase* levelTransitionVolume = GetSingleton<ALevelTransitionVolumeBase>())
+	{
+		levelTransitionVolume->enemyCount++;
+	}
+}
+
+void UActorRegistrySubsystem::UnregisterEnemy(AEnemyBase* enemy)
+{
+	liveEnemies.Remove(enemy);
+}
+
+void UActorRegistrySubsystem::EnemyDefeated(AEnemyBase* enemy)
+{
+	if (liveEnemies.Remove(enemy) == 0)
+	{
+		return;
+	}
+
+	if (ALevelTransitionVolumeBase* levelTransitionVolume = GetSingleton<ALevelTransitionVolumeBase>())
+	{
+		levelTransitionVolume->EnemyDied();
+	}
+
+	BroadcastIfRoomCleared();
+}
+
+void UActorRegistrySubsystem::AddCrowdEnemy()
+{
+	crowdEnemyCount++;
+
+	if (ALevelTransitionVolumeBase* levelTransitionVolume = GetSingleton<ALevelTransitionVolumeBase>())
+	{
+		levelTransitionVolume->enemyCount++;
+	}
+}
+
+void UActorRegistrySubsystem::MoveEnemyToCrowd(AEnemyBase* enemy)
+{
+	if (liveEnemies.Remove(enemy) > 0)
+	{
+		crowdEnemyCount++;
+	}
+}
+
+void UActorRegistrySubsystem::MoveEnemyOutOfCrowd()
+{
+	if (crowdEnemyCount == 0)
+	{
+		return;
+	}
+	crowdEnemyCount--;
+
+	if (ALevelTransitionVolumeBase* levelTransitionVolume = GetSingleton<ALevelTransitionVolumeBase>())
+	{
+		levelTransitionVolume->enemyCount--;
+	}
+}
+
+void UActorRegistrySubsystem::AddQueuedEnemy()
+{
+	queuedEnemyCount++;
+
+	if (ALevelTransitionVolumeBase* levelTransitionVolume = GetSingleton<ALevelTransitionVolumeBase>())
+	{
+		levelTransitionVolume->enemyCount++;
+	}
+}
+
+void UActorRegistrySubsystem::RemoveQueuedEnemy()
+{
+	if (queuedEnemyCount == 0)
+	{
+		return;
+	}
+	queuedEnemyCount--;
+
+	if (ALevelTransitionVolumeBase* levelTransitionVolume = GetSingleton<ALevelTransitionVolumeBase>())
+	{
+		levelTransitionVolume->enemyCount--;
+	}
+
+	// a spawned enemy is already registered, only dropped or failed spawns can empty the room here
+	BroadcastIfRoomCleared();
+}
+
+void UActorRegistrySubsystem::BroadcastIfRoomCleared()
+{
+	if (liveEnemies.Num() == 0 && crowdEnemyCount == 0 && queuedEnemyCount == 0)
+	{
+		roomClearedEvent.Broadcast();
+	}
+}
+
+int32 UActorRegistrySubsystem::GetLiveEnemyCount() const
+{
+	return liveEnemies.Num() + crowdEnemyCount + queuedEnemyCount;
+}
+
+void UActorRegistrySubsystem::GetLiveEnemies(TArray<AEnemyBase*>& outEnemies) const
+{
+	outEnemies.Reset(liveEnemies.Num());
+	for (const TWeakObjectPtr<AEnemyBase>& enemy : liveEnemies)
+	{
+		if (AEnemyBase* liveEnemy = enemy.Get())
+		{
+			outEnemies.Add(liveEnemy);
+		}
+	}
+}
@@ -0,0 +1,101 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "ActorRegistrySubsystem.generated.h"
+
+class AEnemyBase;
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE(FRoomClearedEvent);
+
+/**
+ * Index of the one-per-level actors (level transition volume...) and of the enemies alive in the world,
+ * so spawning an enemy doesn't have to walk every actor of the level.
+ */
+UCLASS()
+class RCT_API UActorRegistrySubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+
+	/** Makes @actor the instance returned for @asClass (its own class if null) */
+	UFUNCTION(BlueprintCallable)
+	void RegisterSingleton(AActor* actor, TSubclassOf<AActor> asClass = nullptr);
+
+	UFUNCTION(BlueprintCallable)
+	void UnregisterSingleton(AActor* actor);
+
+	/** Registered actor of @actorClass, the level is only scanned the first time a class is asked for */
+	UFUNCTION(BlueprintCallable, BlueprintPure)
+	AActor* FindSingleton(TSubclassOf<AActor> actorClass);
+
+	template<typename T>
+	T* GetSingleton()
+	{
+		return Cast<T>(FindSingleton(T::StaticClass()));
+	}
+
+	void RegisterEnemy(AEnemyBase* enemy);
+
+	/** Removes an enemy that left play without being defeated (level unload, pooling) */
+	void UnregisterEnemy(AEnemyBase* enemy);
+
+	/** Called when an enemy's HP hits zero, only the first call per enemy counts */
+	void EnemyDefeated(AEnemyBase* enemy);
+
+	/** An enemy spawned straight into the crowd, it counts towards the room like any other */
+	void AddCrowdEnemy();
+
+	/** @enemy is about to be pooled and live on as a crowd entry, the room keeps counting it */
+	void MoveEnemyToCrowd(AEnemyBase* enemy);
+
+	/** A crowd entry was just promoted to an actor, that RegisterEnemy already counted it again */
+	void MoveEnemyOutOfCrowd();
+
+	/** An enemy waits in UEnemySpawnQueueSubsystem, the room counts it so it can't be cleared before the wave is out */
+	void AddQueuedEnemy();
+
+	/** A queued enemy left the queue, spawned (and counted again) or dropped */
+	void RemoveQueuedEnemy();
+
+	UFUNCTION(BlueprintCallable, BlueprintPure)
+	int32 GetLiveEnemyCount() const;
+
+	void GetLiveEnemies(TArray<AEnemyBase*>& outEnemies) const;
+
+	/** Broadcast when the last live enemy got defeated, or the last queued one was dropped */
+	UPROPERTY(BlueprintAssignable)
+	FRoomClearedEvent roomClearedEvent;
+
+private:
+	void OnActorSpawned(AActor* actor);
+
+	/** Actors of a streamed in level don't go through OnActorSpawned, the next lookup scans again */
+	void OnLevelAddedToWorld(ULevel* level, UWorld* world);
+
+	/** roomClearedEvent once nothing is left, live, in the crowd or queued */
+	void BroadcastIfRoomCleared();
+
+	UPROPERTY()
+	TMap<UClass*, TWeakObjectPtr<AActor>> singletons;
+
+	// Classes already looked up with no actor in the level, filled in when one spawns
+	UPROPERTY()
+	TSet<UClass*> missingSingletons;
+
+	TSet<TWeakObjectPtr<AEnemyBase>> liveEnemies;
+
+	/** Live enemies currently simulated by UEnemyCrowdSubsystem instead of an actor */
+	int32 crowdEnemyCount = 0;
+
+	/** Enemies still waiting in UEnemySpawnQueueSubsystem */
+	int32 queuedEnemyCount = 0;
+
+	FDelegateHandle actorSpawnedHandle;
+	FDelegateHandle levelAddedHandle;
+};
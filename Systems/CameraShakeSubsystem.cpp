@@ -0,0 +1,104 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Systems/CameraShakeSubsystem.h"
+
+#include "Camera/PlayerCameraManager.h"
+#include "GameFramework/PlayerController.h"
+#include "PlayerCharacter/DynamicCameraShake.h"
+
+void UCameraShakeSubsystem::QueueShake(TSubclassOf<UDynamicCameraShake> shakeClass, const FVector& epicenter, const FVector2D& direction,
+	float innerRadius, float outerRadius, float falloff)
+{
+	if (!shakeClass)
+	{
+		return;
+	}
+
+	FPendingShake* shake = pendingShakes.FindByPredicate([shakeClass](const FPendingShake& pending)
+	{
+		return pending.shakeClass == shakeClass;
+	});
+
+	if (shake == nullptr)
+	{
+		shake = &pendingShakes.AddDefaulted_GetRef();
+		shake->shakeClass = shakeClass;
+		shake->innerRadius = innerRadius;
+		shake->outerRadius = outerRadius;
+		shake->falloff = falloff;
+	}
+
+	shake->epicenterSum += epicenter;
+	shake->directionSum += direction;
+	shake->lastDirection = direction;
+	shake->hitCount++;
+}
+
+void UCameraShakeSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	for (const FPendingShake& shake : pendingShakes)
+	{
+		PlayShake(shake);
+	}
+	pendingShakes.Reset();
+}
+
+void UCameraShakeSubsystem::PlayShake(const FPendingShake& shake)
+{
+	FDynamicCameraShakeParams params;
+	params.direction = shake.directionSum;
+	if (params.direction.IsNearlyZero())
+	{
+		// hits from opposite sides cancelled out, keep the latest one
+		params.direction = shake.lastDirection;
+	}
+
+	const FVector epicenter = shake.epicenterSum / shake.hitCount;
+
+	for (FConstPlayerControllerIterator it = GetWorld()->GetPlayerControllerIterator(); it; ++it)
+	{
+		APlayerController* playerController = it->Get();
+		if (playerController == nullptr || !playerController->IsLocalController() || playerController->PlayerCameraManager == nullptr)
+		{
+			continue;
+		}
+
+		APlayerCameraManager* cameraManager = playerController->PlayerCameraManager;
+		const FVector cameraLocation = cameraManager->GetCameraLocation();
+		const float distance = FVector::Dist(epicenter, cameraLocation);
+		if (distance >= shake.outerRadius)
+		{
+			continue;
+		}
+
+		float scale = 1.f;
+		if (distance > shake.innerRadius)
+		{
+			const float distancePercent = (distance - shake.innerRadius) / (shake.outerRadius - shake.innerRadius);
+			scale = FMath::Pow(1.f - distancePercent, shake.falloff);
+		}
+
+		const FRotator towardsEpicenter = (epicenter - cameraLocation).Rotation();
+
+		// single instance shakes get restarted, expired ones come back from the camera modifier's pool
+		UDynamicCameraShake* instance = Cast<UDynamicCameraShake>(
+			cameraManager->StartCameraShake(shake.shakeClass, scale, ECameraShakePlaySpace::UserDefined, towardsEpicenter));
+		if (instance)
+		{
+			instance->ApplyShakeParams(params);
+		}
+	}
+}
+
+bool UCameraShakeSubsystem::IsTickable() const
+{
+	return pendingShakes.Num() > 0;
+}
+
+TStatId UCameraShakeSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UCameraShakeSubsystem, STATGROUP_Tickables);
+}
@@ -0,0 +1,46 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "CameraShakeSubsystem.generated.h"
+
+class UDynamicCameraShake;
+
+/**
+ * Merges every directional shake queued during a frame into one shake per class,
+ * played at the end of the frame for each local player in range.
+ */
+UCLASS()
+class RCT_API UCameraShakeSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	/** Same falloff as UGameplayStatics::PlayWorldCameraShake, oriented towards the epicenter */
+	void QueueShake(TSubclassOf<UDynamicCameraShake> shakeClass, const FVector& epicenter, const FVector2D& direction,
+		float innerRadius = 0.f, float outerRadius = 50000.f, float falloff = 1.f);
+
+	virtual void Tick(float DeltaTime) override;
+	virtual bool IsTickable() const override;
+	virtual TStatId GetStatId() const override;
+
+private:
+	struct FPendingShake
+	{
+		TSubclassOf<UDynamicCameraShake> shakeClass;
+		FVector epicenterSum = FVector::ZeroVector;
+		FVector2D directionSum = FVector2D::Zero();
+		FVector2D lastDirection = FVector2D::Zero();
+		float innerRadius = 0.f;
+		float outerRadius = 0.f;
+		float falloff = 1.f;
+		int32 hitCount = 0;
+	};
+
+	void PlayShake(const FPendingShake& shake);
+
+	// Usually one entry, the arm hit shake
+	TArray<FPendingShake> pendingShakes;
+};
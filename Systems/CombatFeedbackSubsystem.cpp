@@ -0,0 +1,147 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Systems/CombatFeedbackSubsystem.h"
+
+#include "NiagaraComponent.h"
+#include "NiagaraFunctionLibrary.h"
+#include "NiagaraSystem.h"
+#include "Components/AudioComponent.h"
+#include "Kismet/GameplayStatics.h"
+#include "Sound/SoundBase.h"
+
+const FName UCombatFeedbackSubsystem::HitCountParameter(TEXT("User.HitCount"));
+
+void UCombatFeedbackSubsystem::QueueBurst(UNiagaraSystem* system, FVector location, bool bMerge)
+{
+	if (system == nullptr)
+	{
+		return;
+	}
+
+	FPendingBurst* burst = nullptr;
+	if (bMerge)
+	{
+		const float mergeRadiusSquared = burstMergeRadius * burstMergeRadius;
+		burst = pendingBursts.FindByPredicate([system, &location, mergeRadiusSquared](const FPendingBurst& pending)
+		{
+			return pending.bMerge && pending.system == system && FVector::DistSquared(pending.anchor, location) <= mergeRadiusSquared;
+		});
+	}
+
+	if (burst == nullptr)
+	{
+		burst = &pendingBursts.AddDefaulted_GetRef();
+		burst->system = system;
+		burst->anchor = location;
+		burst->bMerge = bMerge;
+	}
+
+	burst->locationSum += location;
+	burst->hitCount++;
+}
+
+void UCombatFeedbackSubsystem::QueueSound2D(USoundBase* sound)
+{
+	if (sound)
+	{
+		pendingSounds.AddUnique(sound);
+	}
+}
+
+void UCombatFeedbackSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	for (const FPendingBurst& burst : pendingBursts)
+	{
+		SpawnBurst(burst);
+	}
+	pendingBursts.Reset();
+
+	for (USoundBase* sound : pendingSounds)
+	{
+		PlaySound(sound);
+	}
+	pendingSounds.Reset();
+}
+
+void UCombatFeedbackSubsystem::SpawnBurst(const FPendingBurst& burst)
+{
+	const FVector location = burst.locationSum / burst.hitCount;
+
+	// AutoRelease hands the component back to the per system pool once it completes
+	UNiagaraComponent* component = UNiagaraFunctionLibrary::SpawnSystemAtLocation(GetWorld(), burst.system, location,
+		FRotator::ZeroRotator, FVector(1.f), true, false, ENCPoolMethod::AutoRelease);
+	if (component)
+	{
+		component->SetVariableInt(HitCountParameter, burst.hitCount);
+		component->Activate(true);
+	}
+}
+
+void UCombatFeedbackSubsystem::PlaySound(USoundBase* sound)
+{
+	FCombatSoundPool& pool = soundPools.FindOrAdd(sound);
+
+	UAudioComponent* freeComponent = nullptr;
+	for (UAudioComponent* component : pool.components)
+	{
+		if (IsValid(component) && !component->IsPlaying())
+		{
+			freeComponent = component;
+			break;
+		}
+	}
+
+	if (freeComponent == nullptr)
+	{
+		pool.components.RemoveAll([](const UAudioComponent* component)
+		{
+			return !IsValid(component);
+		});
+
+		if (pool.components.Num() >= maxVoicesPerSound)
+		{
+			// over the voice cap, the hits already playing cover this one
+			return;
+		}
+
+		freeComponent = UGameplayStatics::CreateSound2D(GetWorld(), sound, 1.f, 1.f, 0.f, nullptr, false, false);
+		if (freeComponent == nullptr)
+		{
+			return;
+		}
+		pool.components.Add(freeComponent);
+	}
+
+	freeComponent->Play();
+}
+
+bool UCombatFeedbackSubsystem::IsTickable() const
+{
+	return pendingBursts.Num() > 0 || pendingSounds.Num() > 0;
+}
+
+TStatId UCombatFeedbackSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UCombatFeedbackSubsystem, STATGROUP_Tickables);
+}
+
+void UCombatFeedbackSubsystem::Deinitialize()
+{
+	for (TPair<USoundBase*, FCombatSoundPool>& pool : soundPools)
+	{
+		for (UAudioComponent* component : pool.Value.components)
+		{
+			if (IsValid(component))
+			{
+				component->Stop();
+				component->DestroyComponent();
+			}
+		}
+	}
+	soundPools.Empty();
+
+	Super::Deinitialize();
+}
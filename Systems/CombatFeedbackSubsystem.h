@@ -0,0 +1,75 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "CombatFeedbackSubsystem.generated.h"
+
+class UNiagaraSystem;
+class USoundBase;
+class UAudioComponent;
+
+USTRUCT()
+struct FCombatSoundPool
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	TArray<UAudioComponent*> components;
+};
+
+/**
+ * Hit effects and sounds for combat. Hit effects queued in the same frame close to each other are merged
+ * into one pooled Niagara burst (the count goes to User.HitCount), and each sound cue plays at most
+ * once per frame with a cap on how many voices of it can run at the same time.
+ */
+UCLASS()
+class RCT_API UCombatFeedbackSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	/** Spawns @system at @location at the end of the frame, joining a nearby burst of it when @bMerge (hit effects, not explosions) */
+	UFUNCTION(BlueprintCallable)
+	void QueueBurst(UNiagaraSystem* system, FVector location, bool bMerge = true);
+
+	UFUNCTION(BlueprintCallable)
+	void QueueSound2D(USoundBase* sound);
+
+	virtual void Tick(float DeltaTime) override;
+	virtual bool IsTickable() const override;
+	virtual TStatId GetStatId() const override;
+	virtual void Deinitialize() override;
+
+	/** Niagara user parameter receiving how many hits a burst stands for */
+	static const FName HitCountParameter;
+
+	/** Merged hits closer than this to an already queued burst of the same system join it */
+	UPROPERTY(BlueprintReadWrite)
+	float burstMergeRadius = 250.f;
+
+	UPROPERTY(BlueprintReadWrite)
+	int32 maxVoicesPerSound = 3;
+
+private:
+	struct FPendingBurst
+	{
+		UNiagaraSystem* system = nullptr;
+		FVector anchor = FVector::ZeroVector;
+		FVector locationSum = FVector::ZeroVector;
+		int32 hitCount = 0;
+		bool bMerge = true;
+	};
+
+	void SpawnBurst(const FPendingBurst& burst);
+	void PlaySound(USoundBase* sound);
+
+	TArray<FPendingBurst> pendingBursts;
+
+	UPROPERTY()
+	TArray<USoundBase*> pendingSounds;
+
+	UPROPERTY()
+	TMap<USoundBase*, FCombatSoundPool> soundPools;
+};
@@ -0,0 +1,124 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Systems/CombatPreloadSubsystem.h"
+
+#include "Engine/AssetManager.h"
+#include "Engine/StreamableManager.h"
+#include "Enemies/EnemyBase.h"
+#include "PlayerCharacter/RCTCharacter.h"
+#include "UObject/UObjectHash.h"
+
+void UCombatPreloadSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	preLoadMapHandle = FCoreUObjectDelegates::PreLoadMap.AddUObject(this, &UCombatPreloadSubsystem::OnPreLoadMap);
+}
+
+void UCombatPreloadSubsystem::Deinitialize()
+{
+	FCoreUObjectDelegates::PreLoadMap.Remove(preLoadMapHandle);
+
+	if (preloadHandle.IsValid())
+	{
+		preloadHandle->ReleaseHandle();
+		preloadHandle.Reset();
+	}
+
+	Super::Deinitialize();
+}
+
+void UCombatPreloadSubsystem::PreloadLevel(FName levelName)
+{
+	TArray<FSoftObjectPath> paths = commonAssets;
+	for (const FLevelPreloadManifest& manifest : levelManifests)
+	{
+		if (manifest.levelName == levelName)
+		{
+			paths.Append(manifest.assets);
+			for (const TSoftClassPtr<AEnemyBase>& enemyClass : manifest.enemyClasses)
+			{
+				paths.AddUnique(enemyClass.ToSoftObjectPath());
+			}
+		}
+	}
+	GatherCharacterAssets(paths);
+
+	RequestLoad(MoveTemp(paths));
+}
+
+void UCombatPreloadSubsystem::GatherCharacterAssets(TArray<FSoftObjectPath>& outPaths) const
+{
+	// the game mode keeps the player class loaded between levels, its defaults hold the Blueprint's values
+	TArray<UClass*> characterClasses;
+	GetDerivedClasses(ARCTCharacter::StaticClass(), characterClasses);
+	characterClasses.Add(ARCTCharacter::StaticClass());
+
+	for (const UClass* characterClass : characterClasses)
+	{
+		if (characterClass->HasAnyClassFlags(CLASS_Abstract | CLASS_NewerVersionExists)
+			|| characterClass->GetName().StartsWith(TEXT("SKEL_")))
+		{
+			continue;
+		}
+		characterClass->GetDefaultObject<ARCTCharacter>()->GetCombatAssets(outPaths);
+	}
+}
+
+float UCombatPreloadSubsystem::GetPreloadProgress() const
+{
+	return preloadHandle.IsValid() ? preloadHandle->GetProgress() : 1.f;
+}
+
+bool UCombatPreloadSubsystem::IsPreloadComplete() const
+{
+	return !preloadHandle.IsValid() || preloadHandle->HasLoadCompleted();
+}
+
+void UCombatPreloadSubsystem::OnPreLoadMap(const FString& mapName)
+{
+	PreloadLevel(FName(*FPackageName::GetShortName(mapName)));
+}
+
+void UCombatPreloadSubsystem::RequestLoad(TArray<FSoftObjectPath>&& paths)
+{
+	paths.RemoveAll([](const FSoftObjectPath& path)
+	{
+		return path.IsNull();
+	});
+
+	// the new handle takes its references before the old one lets go, assets both levels use stay loaded
+	TSharedPtr<FStreamableHandle> previousHandle = preloadHandle;
+	preloadHandle.Reset();
+	if (paths.Num() > 0)
+	{
+		FStreamableManager& streamableManager = UAssetManager::GetStreamableManager();
+		preloadHandle = streamableManager.RequestAsyncLoad(MoveTemp(paths),
+			FStreamableDelegate::CreateUObject(this, &UCombatPreloadSubsystem::OnPreloadComplete),
+			FStreamableManager::AsyncLoadHighPriority);
+	}
+
+	if (previousHandle.IsValid())
+	{
+		// a cancelled handle doesn't call OnPreloadComplete for a manifest nobody waits for anymore
+		if (previousHandle->IsLoadingInProgress())
+		{
+			previousHandle->CancelHandle();
+		}
+		else
+		{
+			previousHandle->ReleaseHandle();
+		}
+	}
+
+	if (!preloadHandle.IsValid())
+	{
+		OnPreloadComplete();
+	}
+}
+
+void UCombatPreloadSubsystem::OnPreloadComplete()
+{
+	preloadCompleteEvent.Broadcast();
+}
@@ -0,0 +1,83 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/GameInstanceSubsystem.h"
+#include "CombatPreloadSubsystem.generated.h"
+
+class AEnemyBase;
+struct FStreamableHandle;
+
+USTRUCT()
+struct FLevelPreloadManifest
+{
+	GENERATED_BODY()
+
+	/** Short map name, Level1 for /Game/Maps/Level1 */
+	UPROPERTY()
+	FName levelName;
+
+	UPROPERTY()
+	TArray<FSoftObjectPath> assets;
+
+	/** Enemy classes the level's waves spawn, loaded with everything they reference */
+	UPROPERTY()
+	TArray<TSoftClassPtr<AEnemyBase>> enemyClasses;
+};
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE(FPreloadCompleteEvent);
+
+/**
+ * Loads the combat assets of a level asynchronously while the level transition runs, so the first arm hit or
+ * explosion doesn't load anything. The manifest is built when the map begins loading from the soft combat
+ * references of every player character class (ARCTCharacter::GetCombatAssets, the arm's included), plus the
+ * level's entry in levelManifests (its assets and wave enemy classes) and commonAssets. Everything stays
+ * referenced until the next level's manifest is loaded.
+ */
+UCLASS(Config = Game)
+class RCT_API UCombatPreloadSubsystem : public UGameInstanceSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+
+	/** Starts loading the manifest of @levelName, called by itself on every map load */
+	UFUNCTION(BlueprintCallable)
+	void PreloadLevel(FName levelName);
+
+	/** 0 to 1, for the loading screen */
+	UFUNCTION(BlueprintCallable, BlueprintPure)
+	float GetPreloadProgress() const;
+
+	UFUNCTION(BlueprintCallable, BlueprintPure)
+	bool IsPreloadComplete() const;
+
+	/** Broadcast every time the current manifest finished loading */
+	UPROPERTY(BlueprintAssignable)
+	FPreloadCompleteEvent preloadCompleteEvent;
+
+protected:
+	UPROPERTY(Config)
+	TArray<FLevelPreloadManifest> levelManifests;
+
+	/** Loaded for every level */
+	UPROPERTY(Config)
+	TArray<FSoftObjectPath> commonAssets;
+
+private:
+	void OnPreLoadMap(const FString& mapName);
+
+	/** Soft combat references of the class defaults of every loaded player character class */
+	void GatherCharacterAssets(TArray<FSoftObjectPath>& outPaths) const;
+
+	void RequestLoad(TArray<FSoftObjectPath>&& paths);
+
+	void OnPreloadComplete();
+
+	TSharedPtr<FStreamableHandle> preloadHandle;
+
+	FDelegateHandle preLoadMapHandle;
+};
@@ -0,0 +1,156 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Systems/DamageOverTimeSubsystem.h"
+
+#include "Enemies/EnemyBase.h"
+#include "PlayerCharacter/RCTCharacter.h"
+
+void UDamageOverTimeSubsystem::AddEffect(AEnemyBase* target, AActor* source, EDamageOverTimeKind kind, float amount, float interval, bool bLifesteal)
+{
+	if (target == nullptr)
+	{
+		return;
+	}
+
+	FDamageOverTimeEffect* effect = effects.FindByPredicate([target, kind](const FDamageOverTimeEffect& existing)
+	{
+		return existing.kind == kind && existing.target == target;
+	});
+	if (effect == nullptr)
+	{
+		effect = &effects.AddDefaulted_GetRef();
+		effect->target = target;
+		effect->kind = kind;
+	}
+
+	effect->source = source;
+	effect->amount = amount;
+	effect->interval = interval;
+	effect->timeUntilNext = interval;
+	effect->bLifesteal = bLifesteal;
+}
+
+void UDamageOverTimeSubsystem::RemoveEffect(AEnemyBase* target, EDamageOverTimeKind kind)
+{
+	effects.RemoveAllSwap([target, kind](const FDamageOverTimeEffect& effect)
+	{
+		return effect.kind == kind && effect.target == target;
+	});
+}
+
+void UDamageOverTimeSubsystem::RemoveAllEffects(AEnemyBase* target)
+{
+	effects.RemoveAllSwap([target](const FDamageOverTimeEffect& effect)
+	{
+		return effect.target == target;
+	});
+}
+
+void UDamageOverTimeSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	// Effects are applied after the walk, damage can kill, pool or destroy a target and change the effect list
+	struct FPendingDamage
+	{
+		AEnemyBase* target;
+		AActor* source;
+		EDamageOverTimeKind kind;
+		float amount;
+	};
+	TArray<FPendingDamage, TInlineAllocator<16>> pendingDamage;
+	TArray<TPair<ARCTCharacter*, float>, TInlineAllocator<2>> lifesteal;
+
+	for (int32 i = effects.Num() - 1; i >= 0; i--)
+	{
+		FDamageOverTimeEffect& effect = effects[i];
+		AEnemyBase* target = effect.target.Get();
+		if (target == nullptr || target->IsPooled())
+		{
+			effects.RemoveAtSwap(i);
+			continue;
+		}
+
+		float amount = 0.f;
+		if (effect.interval <= 0.f)
+		{
+			amount = effect.amount * DeltaTime;
+		}
+		else
+		{
+			effect.timeUntilNext -= DeltaTime;
+			while (effect.timeUntilNext <= 0.f)
+			{
+				amount += effect.amount;
+				effect.timeUntilNext += effect.interval;
+			}
+		}
+
+		if (amount <= 0.f)
+		{
+			continue;
+		}
+
+		// devour stops draining once the enemy is empty and waits for the player to eat it
+		if (effect.kind == EDamageOverTimeKind::Devour && target->GetHealth() <= 0.f)
+		{
+			continue;
+		}
+
+		AActor* source = effect.source.Get();
+		pendingDamage.Add({ target, source, effect.kind, amount });
+
+		if (effect.bLifesteal)
+		{
+			if (ARCTCharacter* character = Cast<ARCTCharacter>(source))
+			{
+				TPair<ARCTCharacter*, float>* entry = lifesteal.FindByPredicate([character](const TPair<ARCTCharacter*, float>& pair)
+				{
+					return pair.Key == character;
+				});
+				if (entry)
+				{
+					entry->Value += amount;
+				}
+				else
+				{
+					lifesteal.Emplace(character, amount);
+				}
+			}
+		}
+	}
+
+	for (const TPair<ARCTCharacter*, float>& entry : lifesteal)
+	{
+		entry.Key->AbsorbAfterDamaging(entry.Value);
+	}
+
+	for (const FPendingDamage& damage : pendingDamage)
+	{
+		if (!IsValid(damage.target) || damage.target->IsPooled())
+		{
+			continue;
+		}
+
+		if (damage.kind == EDamageOverTimeKind::Devour)
+		{
+			damage.target->ModifyHealth(-damage.amount);
+		}
+		else
+		{
+			AController* instigator = damage.source ? damage.source->GetInstigatorController() : nullptr;
+			damage.target->TakeDamage(damage.amount, FPointDamageEvent(), instigator, damage.source);
+		}
+	}
+}
+
+bool UDamageOverTimeSubsystem::IsTickable() const
+{
+	return effects.Num() > 0;
+}
+
+TStatId UDamageOverTimeSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UDamageOverTimeSubsystem, STATGROUP_Tickables);
+}
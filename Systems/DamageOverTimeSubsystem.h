@@ -0,0 +1,58 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "DamageOverTimeSubsystem.generated.h"
+
+class AEnemyBase;
+
+UENUM(BlueprintType)
+enum class EDamageOverTimeKind : uint8
+{
+	/** Held enemy being eaten, drains health without going through TakeDamage so the enemy waits to be devoured */
+	Devour,
+	/** Enemy staying inside the arm, regular damage every interval */
+	ArmStay,
+};
+
+/**
+ * Every damage over time effect in the world, kept in one array and advanced in a single batch per frame.
+ * Lifesteal from all the effects of a source is summed and handed to it once per frame.
+ */
+UCLASS()
+class RCT_API UDamageOverTimeSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	/**
+	 * Starts (or restarts) the @kind effect on @target.
+	 * @interval <= 0 applies @amount per second continuously, otherwise @amount every @interval seconds
+	 * starting one interval from now. A source with lifesteal must be an ARCTCharacter.
+	 */
+	void AddEffect(AEnemyBase* target, AActor* source, EDamageOverTimeKind kind, float amount, float interval, bool bLifesteal);
+
+	void RemoveEffect(AEnemyBase* target, EDamageOverTimeKind kind);
+
+	void RemoveAllEffects(AEnemyBase* target);
+
+	virtual void Tick(float DeltaTime) override;
+	virtual bool IsTickable() const override;
+	virtual TStatId GetStatId() const override;
+
+private:
+	struct FDamageOverTimeEffect
+	{
+		TWeakObjectPtr<AEnemyBase> target;
+		TWeakObjectPtr<AActor> source;
+		EDamageOverTimeKind kind = EDamageOverTimeKind::ArmStay;
+		float amount = 0.f;
+		float interval = 0.f;
+		float timeUntilNext = 0.f;
+		bool bLifesteal = false;
+	};
+
+	TArray<FDamageOverTimeEffect> effects;
+};
@@ -0,0 +1,168 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Systems/DamageQueueSubsystem.h"
+
+#include "Enemies/EnemyBase.h"
+#include "Systems/CombatFeedbackSubsystem.h"
+
+void FDamageQueueTickFunction::ExecuteTick(float DeltaTime, ELevelTick TickType, ENamedThreads::Type CurrentThread, const FGraphEventRef& MyCompletionGraphEvent)
+{
+	if (owner && TickType != LEVELTICK_ViewportsOnly)
+	{
+		owner->ResolveQueue();
+	}
+}
+
+FString FDamageQueueTickFunction::DiagnosticMessage()
+{
+	return TEXT("UDamageQueueSubsystem::ResolveQueue");
+}
+
+void UDamageQueueSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	// set up before anyone's OnWorldBeginPlay, UExplosionSubsystem adds itself as a prerequisite in its Initialize
+	tickFunction.owner = this;
+	tickFunction.bCanEverTick = true;
+	tickFunction.bStartWithTickEnabled = true;
+	tickFunction.TickGroup = TG_PostPhysics;
+}
+
+void UDamageQueueSubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+	Super::OnWorldBeginPlay(InWorld);
+
+	tickFunction.RegisterTickFunction(InWorld.PersistentLevel);
+}
+
+void UDamageQueueSubsystem::Deinitialize()
+{
+	if (tickFunction.IsTickFunctionRegistered())
+	{
+		tickFunction.UnRegisterTickFunction();
+	}
+	tickFunction.owner = nullptr;
+	queue.Empty();
+
+	Super::Deinitialize();
+}
+
+void UDamageQueueSubsystem::QueueDamage(AActor* target, float amount, AController* instigator, AActor* causer, const FQueuedDamageFeedback& feedback)
+{
+	if (target == nullptr)
+	{
+		return;
+	}
+
+	FQueuedDamage& damage = queue.AddDefaulted_GetRef();
+	damage.target = target;
+	damage.instigator = instigator;
+	damage.causer = causer;
+	damage.amount = amount;
+	damage.feedback = feedback;
+}
+
+void UDamageQueueSubsystem::QueueRadialDamage(AActor* target, float amount, const FVector& origin, float radius, const FHitResult& hit, AController* instigator, AActor* causer)
+{
+	if (target == nullptr)
+	{
+		return;
+	}
+
+	FQueuedDamage& damage = queue.AddDefaulted_GetRef();
+	damage.target = target;
+	damage.instigator = instigator;
+	damage.causer = causer;
+	damage.amount = amount;
+	damage.bRadial = true;
+	damage.origin = origin;
+	damage.radius = radius;
+	damage.hit = hit;
+}
+
+void UDamageQueueSubsystem::ResolveQueue()
+{
+	UCombatFeedbackSubsystem* feedbackSubsystem = GetWorld()->GetSubsystem<UCombatFeedbackSubsystem>();
+
+	for (int32 pass = 0; pass < maxPassesPerFrame && queue.Num() > 0; pass++)
+	{
+		// anything queued while resolving goes to the next pass
+		TArray<FQueuedDamage> events = MoveTemp(queue);
+		queue.Reset();
+
+		TMap<AActor*, int32> targetOrder;
+		for (const FQueuedDamage& damage : events)
+		{
+			AActor* target = damage.target.Get();
+			if (!targetOrder.Contains(target))
+			{
+				targetOrder.Add(target, targetOrder.Num());
+			}
+		}
+		events.StableSort([&targetOrder](const FQueuedDamage& a, const FQueuedDamage& b)
+		{
+			return targetOrder[a.target.Get()] < targetOrder[b.target.Get()];
+		});
+
+		int32 i = 0;
+		while (i < events.Num())
+		{
+			AActor* target = events[i].target.Get();
+			FQueuedDamageFeedback feedback;
+
+			for (; i < events.Num() && events[i].target.Get() == target; i++)
+			{
+				if (!IsValid(target))
+				{
+					continue;
+				}
+
+				// the first killing blow wins, the rest of the frame's hits on a corpse are dropped
+				AEnemyBase* enemy = Cast<AEnemyBase>(target);
+				if (enemy && (enemy->IsDead() || enemy->IsPooled()))
+				{
+					continue;
+				}
+
+				ApplyDamage(target, events[i]);
+
+				if (feedback.hitEffect == nullptr)
+				{
+					feedback.hitEffect = events[i].feedback.hitEffect;
+				}
+				if (feedback.hitSound == nullptr)
+				{
+					feedback.hitSound = events[i].feedback.hitSound;
+				}
+			}
+
+			if (feedbackSubsystem && IsValid(target))
+			{
+				feedbackSubsystem->QueueBurst(feedback.hitEffect, target->GetActorLocation());
+				feedbackSubsystem->QueueSound2D(feedback.hitSound);
+			}
+		}
+	}
+}
+
+void UDamageQueueSubsystem::ApplyDamage(AActor* target, const FQueuedDamage& damage)
+{
+	if (damage.bRadial)
+	{
+		FRadialDamageEvent radialDamageEvent;
+		radialDamageEvent.Origin = damage.origin;
+		radialDamageEvent.Params.BaseDamage = damage.amount;
+		// no falloff, like ApplyRadialDamage did, receivers computing their own damage get the full amount
+		radialDamageEvent.Params.InnerRadius = damage.radius;
+		radialDamageEvent.Params.OuterRadius = damage.radius;
+		radialDamageEvent.Params.MinimumDamage = damage.amount;
+		radialDamageEvent.ComponentHits.Add(damage.hit);
+		target->TakeDamage(damage.amount, radialDamageEvent, damage.instigator.Get(), damage.causer.Get());
+	}
+	else
+	{
+		target->TakeDamage(damage.amount, FPointDamageEvent(), damage.instigator.Get(), damage.causer.Get());
+	}
+}
@@ -0,0 +1,91 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/EngineBaseTypes.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "DamageQueueSubsystem.generated.h"
+
+class UDamageQueueSubsystem;
+class UNiagaraSystem;
+class USoundBase;
+
+USTRUCT()
+struct FDamageQueueTickFunction : public FTickFunction
+{
+	GENERATED_BODY()
+
+	UDamageQueueSubsystem* owner = nullptr;
+
+	virtual void ExecuteTick(float DeltaTime, ELevelTick TickType, ENamedThreads::Type CurrentThread, const FGraphEventRef& MyCompletionGraphEvent) override;
+	virtual FString DiagnosticMessage() override;
+};
+
+template<>
+struct TStructOpsTypeTraits<FDamageQueueTickFunction> : public TStructOpsTypeTraitsBase2<FDamageQueueTickFunction>
+{
+	enum
+	{
+		WithCopy = false
+	};
+};
+
+/** Hit effect and sound played once per damaged target, however many hits it took this frame */
+struct FQueuedDamageFeedback
+{
+	UNiagaraSystem* hitEffect = nullptr;
+	USoundBase* hitSound = nullptr;
+};
+
+/**
+ * Collects the damage dealt during the frame (arm hits...) and resolves it in one pass in TG_PostPhysics,
+ * outside of the overlap callbacks that queued it. Events are resolved grouped per target, in the order the
+ * targets were first hit, damage to an already dead enemy is dropped and hit feedback plays once per target.
+ */
+UCLASS()
+class RCT_API UDamageQueueSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+	virtual void Deinitialize() override;
+
+	void QueueDamage(AActor* target, float amount, AController* instigator, AActor* causer, const FQueuedDamageFeedback& feedback = FQueuedDamageFeedback());
+
+	/** @hit is the component of @target the blast reached, it drives the falloff AActor::TakeDamage reports to listeners */
+	void QueueRadialDamage(AActor* target, float amount, const FVector& origin, float radius, const FHitResult& hit, AController* instigator, AActor* causer);
+
+	FTickFunction& GetTickFunction()
+	{
+		return tickFunction;
+	}
+
+	/** Resolves everything queued so far, called by the tick function */
+	void ResolveQueue();
+
+private:
+	struct FQueuedDamage
+	{
+		TWeakObjectPtr<AActor> target;
+		TWeakObjectPtr<AController> instigator;
+		TWeakObjectPtr<AActor> causer;
+		float amount = 0.f;
+		bool bRadial = false;
+		FVector origin = FVector::ZeroVector;
+		float radius = 0.f;
+		FHitResult hit;
+		FQueuedDamageFeedback feedback;
+	};
+
+	void ApplyDamage(AActor* target, const FQueuedDamage& damage);
+
+	TArray<FQueuedDamage> queue;
+
+	/** Damage dealt while resolving (chain reactions) is resolved in the same frame up to this many passes */
+	int32 maxPassesPerFrame = 4;
+
+	FDamageQueueTickFunction tickFunction;
+};
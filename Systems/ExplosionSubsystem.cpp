@@ -0,0 +1,199 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Systems/ExplosionSubsystem.h"
+
+#include "Enemies/GrabableEnemy.h"
+#include "Systems/DamageQueueSubsystem.h"
+
+void FExplosionTickFunction::ExecuteTick(float DeltaTime, ELevelTick TickType, ENamedThreads::Type CurrentThread, const FGraphEventRef& MyCompletionGraphEvent)
+{
+	if (owner && TickType != LEVELTICK_ViewportsOnly)
+	{
+		owner->ResolveExplosions();
+	}
+}
+
+FString FExplosionTickFunction::DiagnosticMessage()
+{
+	return TEXT("UExplosionSubsystem::ResolveExplosions");
+}
+
+void UExplosionSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	tickFunction.owner = this;
+	tickFunction.bCanEverTick = true;
+	tickFunction.bStartWithTickEnabled = true;
+	tickFunction.TickGroup = TG_PostPhysics;
+
+	// the damage of this frame's blasts is resolved in the same frame. AddPrerequisite silently does nothing
+	// unless both tick functions can tick, so the damage queue has to be set up first
+	UDamageQueueSubsystem* damageQueue = Cast<UDamageQueueSubsystem>(Collection.InitializeDependency(UDamageQueueSubsystem::StaticClass()));
+	if (ensure(damageQueue))
+	{
+		FTickFunction& damageTick = damageQueue->GetTickFunction();
+		damageTick.AddPrerequisite(this, tickFunction);
+		ensure(damageTick.GetPrerequisites().Contains(FTickPrerequisite(this, tickFunction)));
+	}
+}
+
+void UExplosionSubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+	Super::OnWorldBeginPlay(InWorld);
+
+	tickFunction.RegisterTickFunction(InWorld.PersistentLevel);
+}
+
+void UExplosionSubsystem::Deinitialize()
+{
+	if (tickFunction.IsTickFunctionRegistered())
+	{
+		tickFunction.UnRegisterTickFunction();
+	}
+	tickFunction.owner = nullptr;
+	queue.Empty();
+
+	Super::Deinitialize();
+}
+
+void UExplosionSubsystem::QueueExplosion(const FVector& origin, float radius, float damage, float impulse, AActor* causer, AController* instigator, const TArray<AActor*>& ignoreActors)
+{
+	FQueuedExplosion& explosion = queue.AddDefaulted_GetRef();
+	explosion.origin = origin;
+	explosion.radius = radius;
+	explosion.damage = damage;
+	explosion.impulse = impulse;
+	explosion.causer = causer;
+	explosion.instigator = instigator;
+	for (AActor* actor : ignoreActors)
+	{
+		explosion.ignoreActors.Add(actor);
+	}
+}
+
+void UExplosionSubsystem::ResolveExplosions()
+{
+	if (queue.Num() == 0)
+	{
+		return;
+	}
+
+	const int32 count = FMath::Min(queue.Num(), maxExplosionsPerFrame);
+
+	// blasts whose reach overlaps share a batch, far apart ones get their own query instead of one spanning both
+	TArray<TPair<FBox, TArray<FQueuedExplosion>>, TInlineAllocator<4>> batches;
+	for (int32 i = 0; i < count; i++)
+	{
+		const FQueuedExplosion& explosion = queue[i];
+		const FBox reach = FBox::BuildAABB(explosion.origin, FVector(explosion.radius));
+
+		TPair<FBox, TArray<FQueuedExplosion>>* batch = batches.FindByPredicate([&reach](const TPair<FBox, TArray<FQueuedExplosion>>& existing)
+		{
+			return existing.Key.Intersect(reach);
+		});
+		if (batch == nullptr)
+		{
+			batch = &batches.AddDefaulted_GetRef();
+			batch->Key = FBox(ForceInit);
+		}
+		batch->Key += reach;
+		batch->Value.Add(explosion);
+	}
+	queue.RemoveAt(0, count, false);
+
+	for (const TPair<FBox, TArray<FQueuedExplosion>>& batch : batches)
+	{
+		ResolveBatch(batch.Key, batch.Value);
+	}
+}
+
+void UExplosionSubsystem::ResolveBatch(const FBox& bounds, const TArray<FQueuedExplosion>& batch)
+{
+	UWorld* world = GetWorld();
+	UDamageQueueSubsystem* damageQueue = world->GetSubsystem<UDamageQueueSubsystem>();
+
+	// one query for the whole batch, each blast then only tests these candidates
+	TArray<FOverlapResult> overlaps;
+	world->OverlapMultiByObjectType(overlaps, bounds.GetCenter(), FQuat::Identity,
+		FCollisionObjectQueryParams(FCollisionObjectQueryParams::InitType::AllDynamicObjects),
+		FCollisionShape::MakeBox(bounds.GetExtent()), FCollisionQueryParams(SCENE_QUERY_STAT(ExplosionOverlap), false));
+
+	TMap<AActor*, TArray<UPrimitiveComponent*, TInlineAllocator<4>>> candidates;
+	for (const FOverlapResult& overlap : overlaps)
+	{
+		AActor* actor = overlap.GetActor();
+		UPrimitiveComponent* component = overlap.GetComponent();
+		if (IsValid(actor) && actor->CanBeDamaged() && component)
+		{
+			candidates.FindOrAdd(actor).AddUnique(component);
+		}
+	}
+
+	for (const FQueuedExplosion& explosion : batch)
+	{
+		FCollisionQueryParams traceParams(SCENE_QUERY_STAT(ExplosionVisibility), true);
+		for (const TWeakObjectPtr<AActor>& ignored : explosion.ignoreActors)
+		{
+			traceParams.AddIgnoredActor(ignored.Get());
+		}
+		const float radiusSquared = FMath::Square(explosion.radius);
+
+		for (const auto& candidate : candidates)
+		{
+			AActor* actor = candidate.Key;
+			if (!IsValid(actor) || explosion.ignoreActors.Contains(actor))
+			{
+				continue;
+			}
+
+			FHitResult hit;
+			bool bReached = false;
+			for (UPrimitiveComponent* component : candidate.Value)
+			{
+				if (IsValid(component)
+					&& component->Bounds.GetBox().ComputeSquaredDistanceToPoint(explosion.origin) <= radiusSquared
+					&& IsReachable(explosion.origin, component, traceParams, hit))
+				{
+					bReached = true;
+					break;
+				}
+			}
+			if (!bReached)
+			{
+				continue;
+			}
+
+			if (damageQueue)
+			{
+				damageQueue->QueueRadialDamage(actor, explosion.damage, explosion.origin, explosion.radius, hit, explosion.instigator.Get(), explosion.causer.Get());
+			}
+
+			if (AGrabableEnemy* enemy = Cast<AGrabableEnemy>(actor))
+			{
+				enemy->ApplyExplosionImpulse(explosion.origin, explosion.radius, explosion.impulse);
+			}
+		}
+	}
+}
+
+bool UExplosionSubsystem::IsReachable(const FVector& origin, UPrimitiveComponent* component, const FCollisionQueryParams& traceParams, FHitResult& outHit) const
+{
+	const FVector target = component->Bounds.Origin;
+
+	FHitResult blockingHit;
+	if (GetWorld()->LineTraceSingleByChannel(blockingHit, origin, target, ECC_Visibility, traceParams))
+	{
+		if (blockingHit.Component == component)
+		{
+			outHit = blockingHit;
+			return true;
+		}
+		return false;
+	}
+
+	// nothing in between, fake a hit on the component the way ApplyRadialDamage does
+	outHit = FHitResult(component->GetOwner(), component, target, (origin - target).GetSafeNormal());
+	return true;
+}
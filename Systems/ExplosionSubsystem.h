@@ -0,0 +1,84 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/EngineBaseTypes.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "ExplosionSubsystem.generated.h"
+
+class UExplosionSubsystem;
+
+USTRUCT()
+struct FExplosionTickFunction : public FTickFunction
+{
+	GENERATED_BODY()
+
+	UExplosionSubsystem* owner = nullptr;
+
+	virtual void ExecuteTick(float DeltaTime, ELevelTick TickType, ENamedThreads::Type CurrentThread, const FGraphEventRef& MyCompletionGraphEvent) override;
+	virtual FString DiagnosticMessage() override;
+};
+
+template<>
+struct TStructOpsTypeTraits<FExplosionTickFunction> : public TStructOpsTypeTraitsBase2<FExplosionTickFunction>
+{
+	enum
+	{
+		WithCopy = false
+	};
+};
+
+/**
+ * Explosions of thrown enemies, queued and resolved together in TG_PostPhysics right before the damage queue.
+ * Blasts whose reach overlaps share one overlap query, the damage goes through UDamageQueueSubsystem and every
+ * grabable enemy reached gets the knockback on its cached static meshes. Up to maxExplosionsPerFrame are resolved
+ * per frame, the rest carries over to the next frame.
+ */
+UCLASS(Config = Game)
+class RCT_API UExplosionSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+	virtual void Deinitialize() override;
+
+	/** Blast of @radius dealing @damage to every damageable actor not in @ignoreActors and not hidden behind a wall */
+	void QueueExplosion(const FVector& origin, float radius, float damage, float impulse, AActor* causer, AController* instigator, const TArray<AActor*>& ignoreActors);
+
+	/** Resolves the queued explosions within the frame budget, called by the tick function */
+	void ResolveExplosions();
+
+	int32 GetPendingCount() const
+	{
+		return queue.Num();
+	}
+
+protected:
+	UPROPERTY(Config)
+	int32 maxExplosionsPerFrame = 16;
+
+private:
+	struct FQueuedExplosion
+	{
+		FVector origin = FVector::ZeroVector;
+		float radius = 0.f;
+		float damage = 0.f;
+		float impulse = 0.f;
+		TWeakObjectPtr<AActor> causer;
+		TWeakObjectPtr<AController> instigator;
+		TArray<TWeakObjectPtr<AActor>, TInlineAllocator<2>> ignoreActors;
+	};
+
+	/** @bounds covers the reach of every blast in @batch */
+	void ResolveBatch(const FBox& bounds, const TArray<FQueuedExplosion>& batch);
+
+	/** Same test as ApplyRadialDamage, a visibility trace from the blast to the component that nothing else blocks */
+	bool IsReachable(const FVector& origin, UPrimitiveComponent* component, const FCollisionQueryParams& traceParams, FHitResult& outHit) const;
+
+	TArray<FQueuedExplosion> queue;
+
+	FExplosionTickFunction tickFunction;
+};
@@ -0,0 +1,32 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "GameplayEventSubsystem.generated.h"
+
+class AEnemyBase;
+
+/** An enemy reached zero health */
+struct FEnemyGameplayEvent
+{
+	AEnemyBase* enemy = nullptr;
+};
+
+DECLARE_MULTICAST_DELEGATE_OneParam(FOnEnemyGameplayEvent, const FEnemyGameplayEvent&);
+
+/**
+ * Native side of the combat events. Listeners subscribe once for the whole world instead of binding to each
+ * enemy on every grab, and the payload goes by reference without reflection. The BlueprintAssignable events
+ * on the actors stay as the Blueprint bridge and are only broadcast when a Blueprint bound them.
+ */
+UCLASS()
+class RCT_API UGameplayEventSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	/** Once per enemy, on the hit that takes its health to zero */
+	FOnEnemyGameplayEvent onEnemyHPZero;
+};
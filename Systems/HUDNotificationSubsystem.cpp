@@ -0,0 +1,97 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Systems/HUDNotificationSubsystem.h"
+
+void UHUDNotificationSubsystem::QueueAttributeDelta(FName attribute, float delta, float newValue)
+{
+	FHUDAttributeUpdate& update = frameUpdates.FindOrAdd(attribute);
+	update.attribute = attribute;
+	update.delta += delta;
+	update.value = newValue;
+	update.changeCount++;
+}
+
+void UHUDNotificationSubsystem::RegisterListener(UObject* listener, FName attribute, FHUDAttributeChangedDelegate callback, float minInterval)
+{
+	if (listener == nullptr || !callback.IsBound())
+	{
+		return;
+	}
+
+	FListener& entry = listeners.AddDefaulted_GetRef();
+	entry.listener = listener;
+	entry.attribute = attribute;
+	entry.callback = callback;
+	entry.minInterval = FMath::Max(minInterval, 0.f);
+	entry.pending.attribute = attribute;
+}
+
+void UHUDNotificationSubsystem::UnregisterListener(UObject* listener)
+{
+	listeners.RemoveAll([listener](const FListener& entry)
+	{
+		return entry.listener == listener;
+	});
+}
+
+void UHUDNotificationSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	const double now = GetWorld()->GetRealTimeSeconds();
+	throttledCount = 0;
+
+	for (int32 i = listeners.Num() - 1; i >= 0; i--)
+	{
+		// a callback may have unregistered other listeners
+		if (i >= listeners.Num())
+		{
+			continue;
+		}
+
+		FListener& entry = listeners[i];
+		if (!entry.listener.IsValid() || !entry.callback.IsBound())
+		{
+			listeners.RemoveAtSwap(i);
+			continue;
+		}
+
+		if (const FHUDAttributeUpdate* update = frameUpdates.Find(entry.attribute))
+		{
+			entry.pending.Merge(*update);
+		}
+
+		if (entry.pending.changeCount == 0)
+		{
+			continue;
+		}
+
+		if (now - entry.lastDispatchTime < entry.minInterval)
+		{
+			throttledCount++;
+			continue;
+		}
+
+		// copy out so the listener can (un)register from inside the callback
+		const FHUDAttributeUpdate update = entry.pending;
+		entry.pending = FHUDAttributeUpdate();
+		entry.pending.attribute = entry.attribute;
+		entry.lastDispatchTime = now;
+
+		const FHUDAttributeChangedDelegate callback = entry.callback;
+		callback.ExecuteIfBound(update);
+	}
+
+	frameUpdates.Reset();
+}
+
+bool UHUDNotificationSubsystem::IsTickable() const
+{
+	return frameUpdates.Num() > 0 || throttledCount > 0;
+}
+
+TStatId UHUDNotificationSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UHUDNotificationSubsystem, STATGROUP_Tickables);
+}
@@ -0,0 +1,85 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "HUDNotificationSubsystem.generated.h"
+
+/**
+ * One coalesced attribute change, covering every delta queued for that attribute since the listener was last notified
+ */
+USTRUCT(BlueprintType)
+struct RCT_API FHUDAttributeUpdate
+{
+	GENERATED_BODY()
+
+	UPROPERTY(BlueprintReadOnly)
+	FName attribute;
+
+	/** Sum of all the deltas queued since the last dispatch */
+	UPROPERTY(BlueprintReadOnly)
+	float delta = 0.f;
+
+	/** Latest value reported for the attribute */
+	UPROPERTY(BlueprintReadOnly)
+	float value = 0.f;
+
+	/** How many individual changes were merged into this update */
+	UPROPERTY(BlueprintReadOnly)
+	int32 changeCount = 0;
+
+	void Merge(const FHUDAttributeUpdate& other)
+	{
+		delta += other.delta;
+		value = other.value;
+		changeCount += other.changeCount;
+	}
+};
+
+DECLARE_DYNAMIC_DELEGATE_OneParam(FHUDAttributeChangedDelegate, const FHUDAttributeUpdate&, update);
+
+/**
+ * Collects attribute deltas (health, stamina...) during the frame and hands each listener
+ * a single merged update at the end of the frame, optionally no more than once per minInterval.
+ */
+UCLASS()
+class RCT_API UHUDNotificationSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	/** Adds @delta to the pending change of @attribute. @newValue is the attribute value after the change */
+	UFUNCTION(BlueprintCallable)
+	void QueueAttributeDelta(FName attribute, float delta, float newValue);
+
+	/** @minInterval is in real seconds, 0 means dispatch every frame a change happened */
+	UFUNCTION(BlueprintCallable)
+	void RegisterListener(UObject* listener, FName attribute, FHUDAttributeChangedDelegate callback, float minInterval = 0.f);
+
+	UFUNCTION(BlueprintCallable)
+	void UnregisterListener(UObject* listener);
+
+	virtual void Tick(float DeltaTime) override;
+	virtual bool IsTickable() const override;
+	virtual TStatId GetStatId() const override;
+
+private:
+	struct FListener
+	{
+		TWeakObjectPtr<UObject> listener;
+		FName attribute;
+		FHUDAttributeChangedDelegate callback;
+		float minInterval = 0.f;
+		double lastDispatchTime = -DBL_MAX;
+		FHUDAttributeUpdate pending;
+	};
+
+	TArray<FListener> listeners;
+
+	// Changes queued this frame, one entry per attribute
+	TMap<FName, FHUDAttributeUpdate> frameUpdates;
+
+	// Rate limited listeners still holding a change they could not send yet
+	int32 throttledCount = 0;
+};